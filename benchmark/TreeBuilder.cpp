@@ -0,0 +1,218 @@
+#include "TreeBuilder.h"
+
+#include <QWidget>
+#include <QCheckBox>
+#include <QRadioButton>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QTabWidget>
+#include <QSplitter>
+#include <QAction>
+#include <QActionGroup>
+
+#include <QDX/WidgetSerializer>
+
+static const int DEEP_DEPTH = 64;
+static const int TAB_PAGES = 8;
+static const int TAB_LEAVES = 4;
+static const int GROUP_ACTIONS = 16;
+
+QDX::TreeBuilder::TreeBuilder(Shape shape, int nodes, int history) : m_shape(shape), m_nodes(qMax(1, nodes)), m_history(qMax(1, history))
+{
+
+}
+
+QWidget *QDX::TreeBuilder::build() const
+{
+	QWidget *root = new QWidget();
+	root->setObjectName("root");
+	switch (m_shape) {
+		case Wide:
+			this->buildWide(root);
+			break;
+		case Deep:
+			this->buildDeep(root);
+			break;
+		case Tabs:
+			this->buildTabs(root);
+			break;
+		case Actions:
+			this->buildActions(root);
+			break;
+		case Combos:
+			this->buildCombos(root);
+			break;
+	}
+	return root;
+}
+
+void QDX::TreeBuilder::mutate(QWidget *root) const
+{
+	for (QCheckBox *check_box : root->findChildren<QCheckBox *>()) {
+		check_box->setChecked(check_box->isChecked() == false);
+	}
+	for (QSpinBox *spin_box : root->findChildren<QSpinBox *>()) {
+		spin_box->setValue(spin_box->value() + 1);
+	}
+	for (QLineEdit *line_edit : root->findChildren<QLineEdit *>()) {
+		line_edit->setText(line_edit->text() + "x");
+	}
+	for (QTabWidget *tabs : root->findChildren<QTabWidget *>()) {
+		tabs->setCurrentIndex((tabs->currentIndex() + 1) % tabs->count());
+	}
+	for (QAction *action : root->findChildren<QAction *>()) {
+		if (action->isCheckable() && action->actionGroup() == nullptr) {
+			action->setChecked(action->isChecked() == false);
+		}
+	}
+	for (QComboBox *combo_box : root->findChildren<QComboBox *>()) {
+		if (combo_box->isEditable()) {
+			combo_box->setCurrentText(combo_box->currentText() + "x");
+		} else {
+			combo_box->setCurrentIndex((combo_box->currentIndex() + 1) % combo_box->count());
+		}
+	}
+}
+
+QString QDX::TreeBuilder::shapeName(Shape shape)
+{
+	switch (shape) {
+		case Wide:
+			return "wide";
+		case Deep:
+			return "deep";
+		case Tabs:
+			return "tabs";
+		case Actions:
+			return "actions";
+		case Combos:
+			return "combos";
+	}
+	return QString();
+}
+
+bool QDX::TreeBuilder::parseShape(const QString &name, Shape &shape)
+{
+	for (Shape candidate : { Wide, Deep, Tabs, Actions, Combos }) {
+		if (shapeName(candidate) == name) {
+			shape = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+QStringList QDX::TreeBuilder::shapeNames()
+{
+	return { shapeName(Wide), shapeName(Deep), shapeName(Tabs), shapeName(Actions), shapeName(Combos) };
+}
+
+void QDX::TreeBuilder::addLeaf(QWidget *parent, int index) const
+{
+	QWidget *leaf = nullptr;
+	switch (index % 6) {
+		case 0:
+			leaf = new QCheckBox(parent);
+			break;
+		case 1:
+			leaf = new QSpinBox(parent);
+			break;
+		case 2:
+			leaf = new QLineEdit(QString("text %1").arg(index), parent);
+			break;
+		case 3: {
+			QComboBox *combo_box = new QComboBox(parent);
+			combo_box->addItems({ "first", "second", "third" });
+			leaf = combo_box;
+			break;
+		}
+		case 4:
+			leaf = new QDoubleSpinBox(parent);
+			break;
+		default:
+			leaf = new QRadioButton(parent);
+			break;
+	}
+	leaf->setObjectName(QString("leaf%1").arg(index));
+}
+
+void QDX::TreeBuilder::addCombo(QWidget *parent, int index) const
+{
+	QComboBox *combo_box = new QComboBox(parent);
+	combo_box->setObjectName(QString("combo%1").arg(index));
+	combo_box->setEditable(true);
+	WidgetSerializer::enableHistory(combo_box, m_history);
+	for (int i = 0; i < m_history; ++i) {
+		combo_box->addItem(QString("history entry %1 of combo %2").arg(i).arg(index));
+	}
+}
+
+void QDX::TreeBuilder::buildWide(QWidget *root) const
+{
+	for (int i = 0; i < m_nodes; ++i) {
+		this->addLeaf(root, i);
+	}
+}
+
+void QDX::TreeBuilder::buildDeep(QWidget *root) const
+{
+	int index = 0;
+	for (int chain = 0; index < m_nodes; ++chain) {
+		QWidget *parent = root;
+		for (int depth = 0; depth < DEEP_DEPTH && index < m_nodes; ++depth) {
+			QWidget *container = new QWidget(parent);
+			container->setObjectName(QString("level%1_%2").arg(chain).arg(depth));
+			this->addLeaf(container, index++);
+			parent = container;
+		}
+	}
+}
+
+void QDX::TreeBuilder::buildTabs(QWidget *root) const
+{
+	int index = 0;
+	for (int tab = 0; index < m_nodes; ++tab) {
+		QTabWidget *tabs = new QTabWidget(root);
+		tabs->setObjectName(QString("tabs%1").arg(tab));
+		++index;
+		for (int page = 0; page < TAB_PAGES && index < m_nodes; ++page) {
+			QWidget *container = new QWidget();
+			container->setObjectName(QString("page%1_%2").arg(tab).arg(page));
+			for (int leaf = 0; leaf < TAB_LEAVES && index < m_nodes; ++leaf) {
+				this->addLeaf(container, index++);
+			}
+			tabs->addTab(container, container->objectName());
+		}
+	}
+}
+
+void QDX::TreeBuilder::buildActions(QWidget *root) const
+{
+	int index = 0;
+	for (int group_index = 0; index < m_nodes; ++group_index) {
+		QActionGroup *group = new QActionGroup(root);
+		group->setObjectName(QString("actionGroup%1").arg(group_index));
+		++index;
+		for (int i = 0; i < GROUP_ACTIONS && index < m_nodes; ++i, ++index) {
+			QAction *action = new QAction(QString("Choice %1").arg(i), group);
+			action->setObjectName(QString("actionChoice%1_%2").arg(group_index).arg(i));
+			action->setCheckable(true);
+			action->setChecked(i == 0);
+		}
+		if (index < m_nodes) {
+			QAction *action = new QAction(QString("Toggle %1").arg(group_index), root);
+			action->setObjectName(QString("actionToggle%1").arg(group_index));
+			action->setCheckable(true);
+			++index;
+		}
+	}
+}
+
+void QDX::TreeBuilder::buildCombos(QWidget *root) const
+{
+	for (int i = 0; i < m_nodes; ++i) {
+		this->addCombo(root, i);
+	}
+}
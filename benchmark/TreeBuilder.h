@@ -0,0 +1,48 @@
+#ifndef QDX_BENCHMARK_TREEBUILDER_H
+#define QDX_BENCHMARK_TREEBUILDER_H
+
+#include <QString>
+#include <QStringList>
+
+class QWidget;
+
+namespace QDX {
+
+	class TreeBuilder
+	{
+	public:
+		enum Shape {
+			Wide,
+			Deep,
+			Tabs,
+			Actions,
+			Combos
+		};
+
+		TreeBuilder(Shape shape, int nodes, int history = 20);
+
+		QWidget *build() const;
+		void mutate(QWidget *root) const;
+
+		static QString shapeName(Shape shape);
+		static bool parseShape(const QString &name, Shape &shape);
+		static QStringList shapeNames();
+
+	private:
+		Shape m_shape;
+		int m_nodes;
+		int m_history;
+
+		void addLeaf(QWidget *parent, int index) const;
+		void addCombo(QWidget *parent, int index) const;
+
+		void buildWide(QWidget *root) const;
+		void buildDeep(QWidget *root) const;
+		void buildTabs(QWidget *root) const;
+		void buildActions(QWidget *root) const;
+		void buildCombos(QWidget *root) const;
+	};
+
+} // namespace QDX
+
+#endif // QDX_BENCHMARK_TREEBUILDER_H
@@ -0,0 +1,13 @@
+QT += core gui widgets
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = widgetserializer-benchmark
+TEMPLATE = app
+
+include(../src/WidgetSerializer.pri)
+
+SOURCES += main.cpp \
+  TreeBuilder.cpp
+HEADERS += TreeBuilder.h
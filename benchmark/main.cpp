@@ -0,0 +1,294 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QSettings>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QWidget>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/SettingsStorage>
+#include <QDX/MemoryStorage>
+#include <QDX/JournalStorage>
+#include <QDX/SnapshotStorage>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "TreeBuilder.h"
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+#define SKIP_EMPTY_PARTS Qt::SkipEmptyParts
+#define ALIGN_LEFT Qt::left
+#define ALIGN_RIGHT Qt::right
+#else
+#define SKIP_EMPTY_PARTS QString::SkipEmptyParts
+#define ALIGN_LEFT left
+#define ALIGN_RIGHT right
+#endif
+
+static std::atomic<qint64> allocations(0);
+
+void *operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void *pointer = std::malloc(size ? size : 1)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+struct Result
+{
+	QString name;
+	double msecs;
+	double nodes_per_second;
+	qint64 allocations;
+};
+
+static qint64 peakMemory()
+{
+	QFile file("/proc/self/status");
+	if (file.open(QIODevice::ReadOnly | QIODevice::Text) == false) {
+		return -1;
+	}
+	while (file.atEnd() == false) {
+		const QByteArray line = file.readLine();
+		if (line.startsWith("VmHWM:")) {
+			return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+		}
+	}
+	return -1;
+}
+
+template <typename Prepare, typename Function>
+static Result measure(const QString &name, int nodes, int repeats, Prepare prepare, Function function)
+{
+	prepare();
+	function();
+
+	Result result = { name, -1.0, 0.0, 0 };
+	QElapsedTimer timer;
+	for (int i = 0; i < repeats; ++i) {
+		prepare();
+		qint64 allocations_before = allocations.load();
+		timer.start();
+		function();
+		double msecs = timer.nsecsElapsed() / 1000000.0;
+		qint64 allocated = allocations.load() - allocations_before;
+		if (result.msecs < 0 || msecs < result.msecs) {
+			result.msecs = msecs;
+			result.allocations = allocated;
+		}
+	}
+	result.nodes_per_second = result.msecs > 0 ? nodes * 1000.0 / result.msecs : 0.0;
+	return result;
+}
+
+static const QStringList &modeNames()
+{
+	static const QStringList names = { "plain", "plans", "tracking", "templates", "lazy" };
+	return names;
+}
+
+static void configure(QDX::WidgetSerializer &serializer, const QString &mode)
+{
+	if (mode == "plans") {
+		serializer.setCachePlans(true);
+	} else if (mode == "tracking") {
+		serializer.setCachePlans(true);
+		serializer.setTrackChanges(true);
+		serializer.setSkipUnchanged(true);
+	} else if (mode == "templates") {
+		serializer.setSharedTemplates(true);
+	} else if (mode == "lazy") {
+		serializer.setLazyLoad(true);
+	}
+}
+
+static void run(QDX::Storage &storage, const QString &prefix, QDX::TreeBuilder::Shape shape, int nodes, int history, int repeats, const QString &mode, QList<Result> &results)
+{
+	QDX::TreeBuilder builder(shape, nodes, history);
+	QWidget *root = builder.build();
+
+	QDX::WidgetSerializer serializer(storage);
+	configure(serializer, mode);
+
+	auto none = []() { };
+	results.append(measure(prefix + "/save", nodes, repeats, none, [&]() {
+		serializer.saveCascade(root, "benchmark");
+		storage.sync();
+	}));
+	results.append(measure(prefix + "/load", nodes, repeats, none, [&]() {
+		serializer.loadCascade(root, "benchmark");
+	}));
+	results.append(measure(prefix + "/restore", nodes, repeats, [&]() {
+		builder.mutate(root);
+	}, [&]() {
+		serializer.loadCascade(root, "benchmark");
+	}));
+
+	delete root;
+}
+
+static QJsonObject toJson(const QList<Result> &results)
+{
+	QJsonArray array;
+	for (const Result &result : results) {
+		QJsonObject object;
+		object.insert("name", result.name);
+		object.insert("msecs", result.msecs);
+		object.insert("allocations", double(result.allocations));
+		array.append(object);
+	}
+	QJsonObject root;
+	root.insert("results", array);
+	return root;
+}
+
+static int compare(const QList<Result> &results, const QString &file_name, double tolerance, QTextStream &out)
+{
+	QFile file(file_name);
+	if (file.open(QIODevice::ReadOnly) == false) {
+		out << "Unable to read baseline " << file_name << "\n";
+		return 2;
+	}
+	QHash<QString, QJsonObject> baseline;
+	for (const QJsonValue &value : QJsonDocument::fromJson(file.readAll()).object().value("results").toArray()) {
+		const QJsonObject object = value.toObject();
+		baseline.insert(object.value("name").toString(), object);
+	}
+
+	int regressions = 0;
+	int missing = 0;
+	for (const Result &result : results) {
+		auto found = baseline.constFind(result.name);
+		if (found == baseline.constEnd()) {
+			++missing;
+			continue;
+		}
+		double msecs = found.value().value("msecs").toDouble();
+		double allocated = found.value().value("allocations").toDouble();
+		bool slower = msecs > 0 && result.msecs > msecs * (1.0 + tolerance);
+		bool heavier = result.allocations > allocated * (1.0 + tolerance);
+		if (slower || heavier) {
+			out << "REGRESSION " << result.name << ": " << result.msecs << " ms (baseline " << msecs << "), "
+				<< result.allocations << " allocations (baseline " << allocated << ")\n";
+			++regressions;
+		}
+	}
+	if (missing > 0) {
+		out << missing << " of " << results.size() << " cases have no baseline entry; regenerate it with --write-baseline\n";
+	}
+	return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	QApplication application(argc, argv);
+	QApplication::setApplicationName("widgetserializer-benchmark");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Measures WidgetSerializer save and load throughput on synthetic widget trees.");
+	parser.addHelpOption();
+	QCommandLineOption shapes_option("shapes", "Comma separated tree shapes: " + QDX::TreeBuilder::shapeNames().join(", ") + ".", "shapes", QDX::TreeBuilder::shapeNames().join(','));
+	QCommandLineOption nodes_option("nodes", "Comma separated tree sizes.", "nodes", "100,1000,10000,100000");
+	QCommandLineOption history_option("history", "Editable combo history length.", "count", "20");
+	QCommandLineOption repeats_option("repeats", "Measured repetitions per case; the best one is reported.", "count", "5");
+	QCommandLineOption backends_option("backends", "Comma separated storage backends: ini, memory, journal, snapshot.", "backends", "ini,memory,journal,snapshot");
+	QCommandLineOption modes_option("modes", "Comma separated serializer modes: " + modeNames().join(", ") + ".", "modes", modeNames().join(','));
+	QCommandLineOption baseline_option("baseline", "Compare against a baseline JSON file.", "file");
+	QCommandLineOption write_baseline_option("write-baseline", "Write the results as a baseline JSON file.", "file");
+	QCommandLineOption tolerance_option("tolerance", "Allowed relative slowdown before a case is reported as a regression.", "ratio", "0.1");
+	parser.addOptions({ shapes_option, nodes_option, history_option, repeats_option, backends_option, modes_option, baseline_option, write_baseline_option, tolerance_option });
+	parser.process(application);
+
+	QTextStream out(stdout);
+	QTemporaryDir directory;
+	int history = parser.value(history_option).toInt();
+	int repeats = qMax(1, parser.value(repeats_option).toInt());
+	const QStringList backends = parser.value(backends_option).split(',', SKIP_EMPTY_PARTS);
+	const QStringList modes = parser.value(modes_option).split(',', SKIP_EMPTY_PARTS);
+	for (const QString &mode : modes) {
+		if (modeNames().contains(mode) == false) {
+			out << "Unknown mode " << mode << "\n";
+			return 2;
+		}
+	}
+
+	QList<Result> results;
+	for (const QString &shape_name : parser.value(shapes_option).split(',', SKIP_EMPTY_PARTS)) {
+		QDX::TreeBuilder::Shape shape;
+		if (QDX::TreeBuilder::parseShape(shape_name, shape) == false) {
+			out << "Unknown shape " << shape_name << "\n";
+			return 2;
+		}
+		for (const QString &nodes_value : parser.value(nodes_option).split(',', SKIP_EMPTY_PARTS)) {
+			int nodes = nodes_value.toInt();
+			for (const QString &backend : backends) {
+				for (const QString &mode : modes) {
+					const QString prefix = QString("%1/%2/%3/%4").arg(shape_name).arg(nodes).arg(backend).arg(mode);
+					const QString file_name = directory.filePath(prefix.split('/').join('_'));
+					if (backend == "ini") {
+						QSettings settings(file_name + ".ini", QSettings::IniFormat);
+						QDX::SettingsStorage storage(settings);
+						run(storage, prefix, shape, nodes, history, repeats, mode, results);
+					} else if (backend == "memory") {
+						QDX::MemoryStorage storage;
+						run(storage, prefix, shape, nodes, history, repeats, mode, results);
+					} else if (backend == "journal") {
+						QDX::JournalStorage storage(file_name + ".qdx");
+						run(storage, prefix, shape, nodes, history, repeats, mode, results);
+					} else if (backend == "snapshot") {
+						QDX::SnapshotStorage storage(file_name + ".qdxs");
+						run(storage, prefix, shape, nodes, history, repeats, mode, results);
+					} else {
+						out << "Unknown backend " << backend << "\n";
+						return 2;
+					}
+					out.flush();
+				}
+			}
+		}
+	}
+
+	out << qSetFieldWidth(40) << ALIGN_LEFT << "case" << qSetFieldWidth(14) << ALIGN_RIGHT << "ms" << "nodes/s" << "allocations" << qSetFieldWidth(0) << "\n";
+	for (const Result &result : qAsConst(results)) {
+		out << qSetFieldWidth(40) << ALIGN_LEFT << result.name << qSetFieldWidth(14) << ALIGN_RIGHT
+			<< QString::number(result.msecs, 'f', 3) << QString::number(result.nodes_per_second, 'f', 0) << result.allocations
+			<< qSetFieldWidth(0) << "\n";
+	}
+	out << "peak memory: " << peakMemory() << " kB\n";
+
+	if (parser.isSet(write_baseline_option)) {
+		QFile file(parser.value(write_baseline_option));
+		if (file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false) {
+			out << "Unable to write baseline " << file.fileName() << "\n";
+			return 2;
+		}
+		file.write(QJsonDocument(toJson(results)).toJson());
+	}
+
+	if (parser.isSet(baseline_option)) {
+		return compare(results, parser.value(baseline_option), parser.value(tolerance_option).toDouble(), out);
+	}
+	return 0;
+}
@@ -0,0 +1,212 @@
+#include "AutoSaver.h"
+
+#include <QWidget>
+#include <QSplitter>
+#include <QAction>
+#include <QActionGroup>
+#include <QComboBox>
+#include <QAbstractItemModel>
+#include <QEvent>
+#include <QMetaMethod>
+
+#include "WidgetSerializer.h"
+#include "SerializationPlan.h"
+#include "Storage.h"
+
+QDX::AutoSaver::AutoSaver(WidgetSerializer &serializer, QObject *root, const QString &group_name, QObject *parent) :
+	QObject(parent), m_serializer(serializer), m_root(root), m_group_name(group_name), m_plan(new SerializationPlan(root, this))
+{
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(1000);
+	connect(&m_timer, &QTimer::timeout, this, &AutoSaver::flush);
+	connect(m_plan, &SerializationPlan::invalidated, this, &AutoSaver::scheduleRebind);
+	this->rebind();
+}
+
+QDX::AutoSaver::~AutoSaver()
+{
+
+}
+
+QDX::WidgetSerializer &QDX::AutoSaver::serializer() const
+{
+	return m_serializer;
+}
+
+QObject *QDX::AutoSaver::root() const
+{
+	return m_root;
+}
+
+QString QDX::AutoSaver::groupName() const
+{
+	return m_group_name;
+}
+
+int QDX::AutoSaver::interval() const
+{
+	return m_timer.interval();
+}
+
+void QDX::AutoSaver::setInterval(int msec)
+{
+	m_timer.setInterval(msec);
+}
+
+int QDX::AutoSaver::pendingCount() const
+{
+	return m_dirty.size();
+}
+
+void QDX::AutoSaver::flush()
+{
+	m_timer.stop();
+	if (m_plan->isValid() == false) {
+		this->rebind();
+	}
+	if (m_dirty.isEmpty() || m_root == nullptr) {
+		return;
+	}
+
+	Storage &storage = m_serializer.storage();
+	QWidget *widget = qobject_cast<QWidget *>(m_root);
+	bool group_opened = false;
+	if (m_group_name.isEmpty() == false || (widget && widget->isWindow())) {
+		storage.beginGroup(m_group_name.isEmpty() ? m_root->objectName() : m_group_name);
+		group_opened = true;
+	}
+
+	int count = 0;
+	for (QObject *object : qAsConst(m_dirty)) {
+		if (m_serializer.isDeferred(object)) {
+			continue;
+		}
+		if (m_serializer.save(object, m_keys.value(object))) {
+			++count;
+		}
+	}
+	m_dirty.clear();
+
+	if (group_opened) {
+		storage.endGroup();
+	}
+
+	emit flushed(count);
+}
+
+void QDX::AutoSaver::rebind()
+{
+	m_rebind_pending = false;
+
+	for (const QPointer<QObject> &object : qAsConst(m_bound)) {
+		if (object) {
+			disconnect(object, nullptr, this, nullptr);
+			object->removeEventFilter(this);
+		}
+	}
+	m_bound.clear();
+	m_keys.clear();
+	m_owners.clear();
+
+	m_plan->compile();
+	if (m_plan->isValid() == false) {
+		m_dirty.clear();
+		return;
+	}
+
+	const QMetaMethod slot = this->metaObject()->method(this->metaObject()->indexOfSlot("changed()"));
+	for (const SerializationPlan::Entry &entry : m_plan->entries()) {
+		if (entry.handler == nullptr || entry.handler->notifiers.isEmpty()) {
+			continue;
+		}
+		for (const QMetaMethod &notifier : entry.handler->notifiers) {
+			connect(entry.object, notifier, this, slot);
+		}
+		m_keys.insert(entry.object, entry.key);
+		m_bound.append(entry.object);
+		this->bindMembers(entry.object, slot);
+	}
+
+	for (auto it = m_dirty.begin(); it != m_dirty.end(); ) {
+		if (m_keys.contains(*it)) {
+			++it;
+		} else {
+			it = m_dirty.erase(it);
+		}
+	}
+}
+
+void QDX::AutoSaver::bindMembers(QObject *object, const QMetaMethod &slot)
+{
+	if (QSplitter *splitter = qobject_cast<QSplitter *>(object)) {
+		splitter->installEventFilter(this);
+		for (int i = 0; i < splitter->count(); ++i) {
+			QWidget *widget = splitter->widget(i);
+			widget->installEventFilter(this);
+			m_owners.insert(widget, splitter);
+			m_bound.append(widget);
+		}
+	} else if (QActionGroup *group = qobject_cast<QActionGroup *>(object)) {
+		const QMetaMethod toggled = QMetaMethod::fromSignal(&QAction::toggled);
+		for (QAction *action : group->actions()) {
+			connect(action, toggled, this, slot);
+			m_owners.insert(action, group);
+			m_bound.append(action);
+		}
+	} else if (QComboBox *combo = qobject_cast<QComboBox *>(object)) {
+		QAbstractItemModel *model = combo->model();
+		if (model == nullptr) {
+			return;
+		}
+		for (const QMetaMethod &notifier : { QMetaMethod::fromSignal(&QAbstractItemModel::rowsInserted), QMetaMethod::fromSignal(&QAbstractItemModel::rowsRemoved), QMetaMethod::fromSignal(&QAbstractItemModel::dataChanged), QMetaMethod::fromSignal(&QAbstractItemModel::modelReset) }) {
+			connect(model, notifier, this, slot, Qt::UniqueConnection);
+		}
+		m_owners.insertMulti(model, combo);
+		m_bound.append(model);
+	}
+}
+
+bool QDX::AutoSaver::eventFilter(QObject *watched, QEvent *event)
+{
+	switch (event->type()) {
+		case QEvent::Resize:
+			this->markDirty(m_owners.value(watched));
+			break;
+		case QEvent::ChildPolished:
+		case QEvent::LayoutRequest:
+			if (qobject_cast<QSplitter *>(watched)) {
+				this->markDirty(watched);
+			}
+			break;
+		default:
+			break;
+	}
+	return QObject::eventFilter(watched, event);
+}
+
+void QDX::AutoSaver::changed()
+{
+	QObject *object = this->sender();
+	this->markDirty(object);
+	for (auto it = m_owners.constFind(object); it != m_owners.constEnd() && it.key() == object; ++it) {
+		this->markDirty(it.value());
+	}
+}
+
+void QDX::AutoSaver::markDirty(QObject *object)
+{
+	if (object == nullptr || m_keys.contains(object) == false) {
+		return;
+	}
+	m_dirty.insert(object);
+	m_timer.start();
+}
+
+void QDX::AutoSaver::scheduleRebind()
+{
+	if (m_rebind_pending) {
+		return;
+	}
+	m_rebind_pending = true;
+	QTimer::singleShot(0, this, &AutoSaver::rebind);
+}
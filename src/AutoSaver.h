@@ -0,0 +1,65 @@
+#ifndef QDX_AUTOSAVER_H
+#define QDX_AUTOSAVER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+namespace QDX {
+
+	class WidgetSerializer;
+	class SerializationPlan;
+
+	class AutoSaver : public QObject
+	{
+		Q_OBJECT
+	public:
+		AutoSaver(WidgetSerializer &serializer, QObject *root, const QString &group_name = QString(), QObject *parent = nullptr);
+		virtual ~AutoSaver();
+
+		WidgetSerializer &serializer() const;
+		QObject *root() const;
+		QString groupName() const;
+
+		int interval() const;
+		void setInterval(int msec);
+
+		int pendingCount() const;
+
+	public slots:
+		void flush();
+		void rebind();
+
+	signals:
+		void flushed(int count);
+
+	protected:
+		bool eventFilter(QObject *watched, QEvent *event) override;
+
+	private slots:
+		void changed();
+
+	private:
+		WidgetSerializer &m_serializer;
+		QPointer<QObject> m_root;
+		QString m_group_name;
+		SerializationPlan *m_plan;
+		QTimer m_timer;
+		bool m_rebind_pending = false;
+
+		QHash<QObject *, QString> m_keys;
+		QHash<QObject *, QObject *> m_owners;
+		QVector<QPointer<QObject>> m_bound;
+		QSet<QObject *> m_dirty;
+
+		void bindMembers(QObject *object, const QMetaMethod &slot);
+		void markDirty(QObject *object);
+		void scheduleRebind();
+	};
+
+} // namespace QDX
+
+#endif // QDX_AUTOSAVER_H
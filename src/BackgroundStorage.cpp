@@ -0,0 +1,155 @@
+#include "BackgroundStorage.h"
+
+#include <QRunnable>
+#include <QMutexLocker>
+
+class QDX::BackgroundStorage::Writer : public QRunnable
+{
+public:
+	Writer(BackgroundStorage &storage) : m_storage(storage)
+	{
+
+	}
+
+	void run() override
+	{
+		m_storage.drain();
+	}
+
+private:
+	BackgroundStorage &m_storage;
+};
+
+void QDX::BackgroundStorage::Batch::add(const Change &change)
+{
+	if (change.erased) {
+		writes.clear();
+		changes.append(change);
+		return;
+	}
+	auto found = writes.constFind(change.path);
+	if (found != writes.constEnd()) {
+		changes[found.value()].value = change.value;
+		return;
+	}
+	writes.insert(change.path, changes.size());
+	changes.append(change);
+}
+
+void QDX::BackgroundStorage::Batch::merge(const Batch &batch)
+{
+	for (const Change &change : batch.changes) {
+		this->add(change);
+	}
+}
+
+bool QDX::BackgroundStorage::Batch::isEmpty() const
+{
+	return changes.isEmpty();
+}
+
+void QDX::BackgroundStorage::Batch::clear()
+{
+	changes.clear();
+	writes.clear();
+}
+
+QDX::BackgroundStorage::BackgroundStorage(Storage &target) : m_target(target)
+{
+	m_pool.setMaxThreadCount(1);
+	for (const QString &path : target.keys()) {
+		m_values.insert(path, target.read(path));
+	}
+}
+
+QDX::BackgroundStorage::~BackgroundStorage()
+{
+	this->flush();
+}
+
+QDX::Storage &QDX::BackgroundStorage::target() const
+{
+	return m_target;
+}
+
+void QDX::BackgroundStorage::write(const QString &path, const QVariant &value)
+{
+	auto found = m_values.constFind(path);
+	if (found != m_values.constEnd() && found.value() == value) {
+		return;
+	}
+	MemoryStorage::write(path, value);
+	m_pending.add({ path, value, false });
+}
+
+void QDX::BackgroundStorage::erase(const QString &path)
+{
+	MemoryStorage::erase(path);
+	m_pending.add({ path, QVariant(), true });
+}
+
+void QDX::BackgroundStorage::eraseAll(const QStringList &paths)
+{
+	MemoryStorage::eraseAll(paths);
+	for (const QString &path : paths) {
+		m_pending.add({ path, QVariant(), true });
+	}
+}
+
+bool QDX::BackgroundStorage::sync()
+{
+	if (m_pending.isEmpty()) {
+		return m_failed.loadAcquire() == 0;
+	}
+	QMutexLocker locker(&m_mutex);
+	m_queued.merge(m_pending);
+	m_pending.clear();
+	if (m_running == false) {
+		m_running = true;
+		m_pool.start(new Writer(*this));
+	}
+	return m_failed.loadAcquire() == 0;
+}
+
+bool QDX::BackgroundStorage::rewrite()
+{
+	return this->flush();
+}
+
+bool QDX::BackgroundStorage::flush()
+{
+	this->sync();
+	m_pool.waitForDone();
+	return m_failed.loadAcquire() == 0;
+}
+
+bool QDX::BackgroundStorage::isIdle() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_running == false && m_pending.isEmpty();
+}
+
+void QDX::BackgroundStorage::drain()
+{
+	Batch batch;
+	while (true) {
+		{
+			QMutexLocker locker(&m_mutex);
+			if (m_queued.isEmpty()) {
+				m_running = false;
+				return;
+			}
+			batch.changes.swap(m_queued.changes);
+			m_queued.clear();
+		}
+		for (const Change &change : qAsConst(batch.changes)) {
+			if (change.erased) {
+				m_target.erase(change.path);
+			} else {
+				m_target.write(change.path, change.value);
+			}
+		}
+		batch.clear();
+		m_failed.storeRelease(m_target.sync() ? 0 : 1);
+	}
+}
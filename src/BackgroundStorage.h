@@ -0,0 +1,67 @@
+#ifndef QDX_BACKGROUNDSTORAGE_H
+#define QDX_BACKGROUNDSTORAGE_H
+
+#include <QMutex>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QVector>
+#include <QHash>
+
+#include "MemoryStorage.h"
+
+namespace QDX {
+
+	class BackgroundStorage : public MemoryStorage
+	{
+	public:
+		BackgroundStorage(Storage &target);
+		virtual ~BackgroundStorage();
+
+		Storage &target() const;
+
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		void eraseAll(const QStringList &paths) override;
+
+		bool sync() override;
+		bool rewrite() override;
+		bool flush();
+
+		bool isIdle() const;
+
+	private:
+		class Writer;
+
+		struct Change
+		{
+			QString path;
+			QVariant value;
+			bool erased;
+		};
+
+		struct Batch
+		{
+			QVector<Change> changes;
+			QHash<QString, int> writes;
+
+			void add(const Change &change);
+			void merge(const Batch &batch);
+			bool isEmpty() const;
+			void clear();
+		};
+
+		Storage &m_target;
+		Batch m_pending;
+
+		mutable QMutex m_mutex;
+		Batch m_queued;
+		bool m_running = false;
+		QAtomicInt m_failed;
+		QThreadPool m_pool;
+
+		void drain();
+	};
+
+} // namespace QDX
+
+#endif // QDX_BACKGROUNDSTORAGE_H
@@ -0,0 +1,334 @@
+#include "CascadeTask.h"
+
+#include <QEvent>
+#include <QElapsedTimer>
+#include <QSignalBlocker>
+#include <QWidget>
+
+#include "SerializationPlan.h"
+#include "TransactionStorage.h"
+
+QDX::CascadeTask::CascadeTask(const WidgetSerializer &serializer, QObject *root, bool is_load, const QString &group_name, QObject *parent) :
+	QObject(parent), m_serializer(serializer), m_root(root), m_group_name(group_name), m_is_load(is_load)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(0);
+	connect(&m_timer, &QTimer::timeout, this, &CascadeTask::process);
+	m_serializer.m_tasks.append(this);
+	if (root) {
+		connect(root, &QObject::destroyed, this, &CascadeTask::cancel);
+		root->installEventFilter(this);
+	}
+}
+
+QDX::CascadeTask::~CascadeTask()
+{
+	if (m_finished == false) {
+		m_serializer.m_tasks.removeOne(this);
+	}
+	if (m_root) {
+		m_root->removeEventFilter(this);
+	}
+	if (m_transaction) {
+		delete m_transaction;
+		m_serializer.resetTracking();
+	}
+}
+
+QObject *QDX::CascadeTask::root() const
+{
+	return m_root;
+}
+
+QString QDX::CascadeTask::groupName() const
+{
+	return m_group_name;
+}
+
+bool QDX::CascadeTask::isLoad() const
+{
+	return m_is_load;
+}
+
+int QDX::CascadeTask::sliceDuration() const
+{
+	return m_slice_duration;
+}
+
+void QDX::CascadeTask::setSliceDuration(int msec)
+{
+	m_slice_duration = qMax(1, msec);
+}
+
+int QDX::CascadeTask::done() const
+{
+	return m_done;
+}
+
+int QDX::CascadeTask::total() const
+{
+	return m_items.size();
+}
+
+int QDX::CascadeTask::writeCount() const
+{
+	return m_write_count;
+}
+
+bool QDX::CascadeTask::isRunning() const
+{
+	return m_started && m_finished == false;
+}
+
+bool QDX::CascadeTask::isFinished() const
+{
+	return m_finished;
+}
+
+bool QDX::CascadeTask::isCanceled() const
+{
+	return m_canceled;
+}
+
+void QDX::CascadeTask::start()
+{
+	if (m_started || m_finished) {
+		return;
+	}
+	m_started = true;
+	if (m_root == nullptr) {
+		this->finish(false);
+		return;
+	}
+	if (m_is_load == false && m_serializer.inTransaction() == false) {
+		Storage &base = *m_serializer.m_storage;
+		m_transaction = new TransactionStorage(base);
+		if (base.group().isEmpty() == false) {
+			m_transaction->beginGroup(base.group());
+		}
+	}
+	m_timer.start();
+}
+
+void QDX::CascadeTask::cancel()
+{
+	if (m_finished) {
+		return;
+	}
+	m_canceled = true;
+	m_timer.stop();
+	this->finish(false);
+}
+
+bool QDX::CascadeTask::eventFilter(QObject *watched, QEvent *event)
+{
+	if (watched == m_root && event->type() == QEvent::Close && m_finished == false) {
+		this->cancel();
+	}
+	return QObject::eventFilter(watched, event);
+}
+
+void QDX::CascadeTask::prepare()
+{
+	SerializationPlan local_plan(m_root);
+	SerializationPlan *plan = &local_plan;
+	if (m_serializer.cachePlans() || (m_is_load && m_serializer.lazyLoad()) || m_serializer.sharedTemplates()) {
+		plan = m_serializer.plan(m_root);
+	} else {
+		local_plan.setWatching(false);
+		m_serializer.preparePlan(local_plan);
+	}
+	const QVector<SerializationPlan::Entry> &entries = plan->entries();
+	const QVector<SerializationPlan::Page> &pages = plan->pages();
+	bool paged = (m_is_load && m_serializer.lazyLoad()) || m_serializer.m_lazy_restores.isEmpty() == false;
+	m_items.reserve(entries.size());
+	int page = 0;
+	for (int i = 0; i < entries.size(); ) {
+		if (paged) {
+			while (page < pages.size() && pages.at(page).begin < i) {
+				++page;
+			}
+			bool skipped = false;
+			while (page < pages.size() && pages.at(page).begin == i) {
+				const SerializationPlan::Page &current = pages.at(page++);
+				if (current.end > current.begin && m_serializer.skipPage(current.object, plan->root(), m_is_load)) {
+					i = current.end;
+					skipped = true;
+					break;
+				}
+			}
+			if (skipped) {
+				continue;
+			}
+		}
+		const SerializationPlan::Entry &entry = entries.at(i++);
+		m_items.append({ entry.object, entry.handler, entry.key });
+	}
+}
+
+void QDX::CascadeTask::process()
+{
+	if (m_finished) {
+		return;
+	}
+	if (m_root == nullptr) {
+		this->cancel();
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	bool first = m_begun == false;
+	this->resume();
+
+	if (first) {
+		this->prepare();
+	}
+
+	if (first && m_serializer.omitWindow() == false) {
+		if (m_is_load) {
+			m_serializer.loadWindow(qobject_cast<QWidget *>(m_root));
+		} else {
+			m_serializer.saveWindow(qobject_cast<QWidget *>(m_root));
+		}
+	}
+
+	int count = m_items.size();
+	while (m_done < count && m_finished == false) {
+		const Item &item = m_items.at(m_done++);
+		if (item.object) {
+			QSignalBlocker blocker(m_is_load && m_serializer.suppressSignals() ? item.object.data() : nullptr);
+			m_serializer.dispatch(item.handler.data(), item.object, item.key, m_is_load);
+		}
+		if (timer.hasExpired(m_slice_duration)) {
+			break;
+		}
+	}
+	if (m_finished) {
+		return;
+	}
+
+	this->suspend();
+
+	emit progress(m_done, count);
+
+	if (m_done < count) {
+		m_timer.start();
+	} else {
+		this->finish(true);
+	}
+}
+
+void QDX::CascadeTask::resume()
+{
+	if (m_active) {
+		return;
+	}
+	m_active = true;
+	if (m_transaction) {
+		m_base = m_serializer.m_storage;
+		m_serializer.m_storage = m_transaction;
+	}
+	if (m_begun == false) {
+		m_begun = true;
+		m_cascade = m_serializer.beginCascade(m_root, m_is_load, m_group_name);
+		m_group = m_group_name.isEmpty() ? m_root->objectName() : m_group_name;
+		return;
+	}
+	if (m_cascade.group_opened) {
+		m_serializer.m_storage->beginGroup(m_group);
+	}
+	if (m_cascade.prefetched) {
+		m_serializer.m_prefetch_values.swap(m_prefetch_values);
+		m_serializer.m_prefetched = true;
+	}
+	if (m_cascade.reporting) {
+		m_serializer.m_report = m_report;
+		m_serializer.m_reporting = true;
+		m_serializer.m_report_started += m_suspended.nsecsElapsed();
+	}
+	if (m_cascade.restoring) {
+		m_serializer.m_restored.swap(m_restored);
+		m_serializer.m_restoring = true;
+	}
+	if (m_cascade.suppressed) {
+		m_cascade.suppressed->setUpdatesEnabled(false);
+	}
+	if (m_is_load == false) {
+		m_serializer.m_write_count = 0;
+	}
+}
+
+void QDX::CascadeTask::suspend()
+{
+	if (m_active == false) {
+		return;
+	}
+	m_active = false;
+	if (m_is_load == false) {
+		m_write_count += m_serializer.writeCount();
+	}
+	if (m_cascade.suppressed) {
+		m_cascade.suppressed->setUpdatesEnabled(true);
+	}
+	if (m_cascade.restoring) {
+		m_restored.swap(m_serializer.m_restored);
+		m_serializer.m_restoring = false;
+	}
+	if (m_cascade.reporting) {
+		m_report = m_serializer.m_report;
+		m_serializer.m_reporting = false;
+		m_suspended.start();
+	}
+	if (m_cascade.prefetched) {
+		m_prefetch_values.swap(m_serializer.m_prefetch_values);
+		m_serializer.m_prefetch_values.clear();
+		m_serializer.m_prefetched = false;
+	}
+	if (m_cascade.group_opened) {
+		m_serializer.m_storage->endGroup();
+	}
+	if (m_transaction) {
+		m_serializer.m_storage = m_base;
+	}
+}
+
+void QDX::CascadeTask::finish(bool completed)
+{
+	m_finished = true;
+	m_serializer.m_tasks.removeOne(this);
+	if (m_begun) {
+		if (m_root == nullptr) {
+			m_cascade.suppressed = nullptr;
+		}
+		this->resume();
+		if (completed == false && m_cascade.restoring) {
+			m_serializer.m_restoring = false;
+			m_serializer.m_restored.clear();
+			m_cascade.restoring = false;
+		}
+		if (m_is_load == false) {
+			m_write_count += m_serializer.writeCount();
+		}
+		m_serializer.endCascade(m_cascade);
+		m_active = false;
+		if (m_transaction) {
+			m_serializer.m_storage = m_base;
+		}
+	}
+	if (m_transaction) {
+		if (completed) {
+			m_transaction->commit();
+		} else {
+			m_serializer.resetTracking();
+		}
+		delete m_transaction;
+		m_transaction = nullptr;
+	}
+	m_items.clear();
+	m_restored.clear();
+	m_prefetch_values.clear();
+	emit finished(completed);
+	this->deleteLater();
+}
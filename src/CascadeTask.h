@@ -0,0 +1,98 @@
+#ifndef QDX_CASCADETASK_H
+#define QDX_CASCADETASK_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QVariant>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "WidgetSerializer.h"
+
+namespace QDX {
+
+	class Storage;
+	class TransactionStorage;
+
+	class CascadeTask : public QObject
+	{
+		Q_OBJECT
+	public:
+		CascadeTask(const WidgetSerializer &serializer, QObject *root, bool is_load, const QString &group_name = QString(), QObject *parent = nullptr);
+		virtual ~CascadeTask();
+
+		QObject *root() const;
+		QString groupName() const;
+		bool isLoad() const;
+
+		int sliceDuration() const;
+		void setSliceDuration(int msec);
+
+		int done() const;
+		int total() const;
+		int writeCount() const;
+
+		bool isRunning() const;
+		bool isFinished() const;
+		bool isCanceled() const;
+
+	public slots:
+		void start();
+		void cancel();
+
+	signals:
+		void progress(int done, int total);
+		void finished(bool completed);
+
+	protected:
+		bool eventFilter(QObject *watched, QEvent *event) override;
+
+	private slots:
+		void process();
+
+	private:
+		struct Item
+		{
+			QPointer<QObject> object;
+			QSharedPointer<const WidgetSerializer::TypeHandler> handler;
+			QString key;
+		};
+
+		const WidgetSerializer &m_serializer;
+		QPointer<QObject> m_root;
+		QString m_group_name;
+		bool m_is_load;
+		int m_slice_duration = 8;
+
+		QVector<Item> m_items;
+		int m_done = 0;
+		int m_write_count = 0;
+		bool m_started = false;
+		bool m_finished = false;
+		bool m_canceled = false;
+		bool m_begun = false;
+		bool m_active = false;
+
+		WidgetSerializer::Cascade m_cascade;
+		QString m_group;
+		TransactionStorage *m_transaction = nullptr;
+		Storage *m_base = nullptr;
+		QHash<QString, QVariant> m_prefetch_values;
+		WidgetSerializer::Report m_report;
+		QElapsedTimer m_suspended;
+		QList<QObject *> m_restored;
+
+		QTimer m_timer;
+
+		void prepare();
+		void resume();
+		void suspend();
+		void finish(bool completed);
+	};
+
+} // namespace QDX
+
+#endif // QDX_CASCADETASK_H
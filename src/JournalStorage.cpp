@@ -0,0 +1,287 @@
+#include "JournalStorage.h"
+#include "SnapshotStorage.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QRunnable>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+enum JournalOperation : quint8 {
+	JournalWrite,
+	JournalErase
+};
+
+namespace {
+
+	class CompactionTask : public QRunnable
+	{
+	public:
+		CompactionTask(const QString &file_name, const QString &rotated_file_name, const QDX::MemoryStorage::Values &values) :
+			m_file_name(file_name), m_rotated_file_name(rotated_file_name), m_values(values)
+		{
+
+		}
+
+		void run() override
+		{
+			if (QDX::SnapshotStorage::writeFile(m_file_name, m_values)) {
+				QFile::remove(m_rotated_file_name);
+			} else {
+				qWarning("QDX::JournalStorage: unable to compact journal into \"%s\"", qPrintable(m_file_name));
+			}
+		}
+
+	private:
+		QString m_file_name;
+		QString m_rotated_file_name;
+		QDX::MemoryStorage::Values m_values;
+	};
+
+	bool syncFile(QFile &file)
+	{
+		if (file.flush() == false) {
+			return false;
+		}
+#ifdef Q_OS_WIN
+		return _commit(file.handle()) == 0;
+#else
+		return ::fsync(file.handle()) == 0;
+#endif
+	}
+
+} // namespace
+
+QDX::JournalStorage::JournalStorage(const QString &file_name) : m_file_name(file_name)
+{
+	m_pool.setMaxThreadCount(1);
+}
+
+QDX::JournalStorage::~JournalStorage()
+{
+	this->append();
+	m_pool.waitForDone();
+}
+
+QString QDX::JournalStorage::fileName() const
+{
+	return m_file_name;
+}
+
+void QDX::JournalStorage::setFileName(const QString &file_name)
+{
+	m_pool.waitForDone();
+	m_file_name = file_name;
+	m_journal_size = QFileInfo(this->journalFileName()).size();
+}
+
+QString QDX::JournalStorage::journalFileName() const
+{
+	return m_file_name + ".journal";
+}
+
+QString QDX::JournalStorage::rotatedFileName() const
+{
+	return m_file_name + ".journal.old";
+}
+
+qint64 QDX::JournalStorage::compactThreshold() const
+{
+	return m_compact_threshold;
+}
+
+void QDX::JournalStorage::setCompactThreshold(qint64 compact_threshold)
+{
+	m_compact_threshold = compact_threshold;
+}
+
+qint64 QDX::JournalStorage::journalSize() const
+{
+	return m_journal_size;
+}
+
+bool QDX::JournalStorage::load()
+{
+	m_pool.waitForDone();
+	m_changes.clear();
+	m_values.clear();
+	if (QFile::exists(m_file_name) && SnapshotStorage::readFile(m_file_name, m_values) == false) {
+		return false;
+	}
+	this->replay(this->rotatedFileName());
+	this->replay(this->journalFileName());
+	m_journal_size = QFileInfo(this->journalFileName()).size();
+	return true;
+}
+
+bool QDX::JournalStorage::replay(const QString &file_name)
+{
+	QFile file(file_name);
+	if (file.open(QIODevice::ReadOnly) == false) {
+		return false;
+	}
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	QByteArray record;
+	quint16 checksum = 0;
+	quint8 operation = 0;
+	QString path;
+	QVariant value;
+	qint64 valid_size = 0;
+	bool torn = false;
+	while (stream.atEnd() == false) {
+		stream >> record >> checksum;
+		if (stream.status() != QDataStream::Ok || qChecksum(record.constData(), uint(record.size())) != checksum) {
+			qWarning("QDX::JournalStorage: discarding torn tail of \"%s\"", qPrintable(file_name));
+			torn = true;
+			break;
+		}
+		QDataStream entry(record);
+		entry.setVersion(QDataStream::Qt_5_6);
+		entry >> operation >> path;
+		if (operation == JournalWrite) {
+			entry >> value;
+			MemoryStorage::write(path, value);
+		} else {
+			MemoryStorage::erase(path);
+		}
+		valid_size = file.pos();
+	}
+	file.close();
+	if (torn && QFile::resize(file_name, valid_size) == false) {
+		qWarning("QDX::JournalStorage: unable to truncate \"%s\"", qPrintable(file_name));
+		return false;
+	}
+	return true;
+}
+
+void QDX::JournalStorage::write(const QString &path, const QVariant &value)
+{
+	auto found = m_values.constFind(path);
+	if (found != m_values.constEnd() && found.value() == value) {
+		return;
+	}
+	MemoryStorage::write(path, value);
+	m_changes.append({ path, value, false });
+}
+
+void QDX::JournalStorage::erase(const QString &path)
+{
+	MemoryStorage::erase(path);
+	m_changes.append({ path, QVariant(), true });
+}
+
+void QDX::JournalStorage::eraseAll(const QStringList &paths)
+{
+	MemoryStorage::eraseAll(paths);
+	for (const QString &path : paths) {
+		m_changes.append({ path, QVariant(), true });
+	}
+}
+
+bool QDX::JournalStorage::append()
+{
+	if (m_changes.isEmpty()) {
+		return true;
+	}
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	for (const Change &change : qAsConst(m_changes)) {
+		QByteArray record;
+		QDataStream entry(&record, QIODevice::WriteOnly);
+		entry.setVersion(QDataStream::Qt_5_6);
+		if (change.erased) {
+			entry << quint8(JournalErase) << change.path;
+		} else {
+			entry << quint8(JournalWrite) << change.path << change.value;
+		}
+		stream << record << qChecksum(record.constData(), uint(record.size()));
+	}
+
+	QFile file(this->journalFileName());
+	if (file.open(QIODevice::WriteOnly | QIODevice::Append) == false) {
+		return false;
+	}
+	if (file.write(data) != data.size() || syncFile(file) == false) {
+		return false;
+	}
+	m_journal_size = file.size();
+	m_changes.clear();
+	return true;
+}
+
+bool QDX::JournalStorage::compact()
+{
+	if (this->append() == false || m_pool.waitForDone(0) == false) {
+		return false;
+	}
+
+	const QString journal_file_name = this->journalFileName();
+	const QString rotated_file_name = this->rotatedFileName();
+	if (QFile::exists(journal_file_name)) {
+		if (QFile::exists(rotated_file_name)) {
+			QFile journal(journal_file_name), rotated(rotated_file_name);
+			if (journal.open(QIODevice::ReadOnly) == false || rotated.open(QIODevice::WriteOnly | QIODevice::Append) == false) {
+				return false;
+			}
+			const QByteArray data = journal.readAll();
+			if (rotated.write(data) != data.size() || syncFile(rotated) == false) {
+				return false;
+			}
+			journal.close();
+			QFile::remove(journal_file_name);
+		} else if (QFile::rename(journal_file_name, rotated_file_name) == false) {
+			return false;
+		}
+	}
+	m_journal_size = 0;
+
+	m_pool.start(new CompactionTask(m_file_name, rotated_file_name, m_values));
+	return true;
+}
+
+void QDX::JournalStorage::waitForCompaction()
+{
+	m_pool.waitForDone();
+}
+
+bool QDX::JournalStorage::rewrite()
+{
+	m_pool.waitForDone();
+	if (this->compact() == false) {
+		return false;
+	}
+	m_pool.waitForDone();
+	return QFile::exists(this->rotatedFileName()) == false;
+}
+
+qint64 QDX::JournalStorage::storedSize() const
+{
+	qint64 size = 0;
+	for (const QString &file_name : { m_file_name, this->journalFileName(), this->rotatedFileName() }) {
+		QFileInfo info(file_name);
+		if (info.isFile()) {
+			size += info.size();
+		}
+	}
+	return size;
+}
+
+bool QDX::JournalStorage::sync()
+{
+	if (this->append() == false) {
+		return false;
+	}
+	if (m_compact_threshold >= 0 && m_journal_size > m_compact_threshold) {
+		this->compact();
+	}
+	return true;
+}
@@ -0,0 +1,60 @@
+#ifndef QDX_JOURNALSTORAGE_H
+#define QDX_JOURNALSTORAGE_H
+
+#include <QThreadPool>
+#include <QVector>
+
+#include "MemoryStorage.h"
+
+namespace QDX {
+
+	class JournalStorage : public MemoryStorage
+	{
+	public:
+		JournalStorage(const QString &file_name = QString());
+		virtual ~JournalStorage();
+
+		QString fileName() const;
+		void setFileName(const QString &file_name);
+
+		QString journalFileName() const;
+
+		qint64 compactThreshold() const;
+		void setCompactThreshold(qint64 compact_threshold);
+
+		qint64 journalSize() const;
+
+		bool load();
+		bool compact();
+		void waitForCompaction();
+
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		void eraseAll(const QStringList &paths) override;
+
+		bool sync() override;
+		bool rewrite() override;
+		qint64 storedSize() const override;
+
+	private:
+		struct Change
+		{
+			QString path;
+			QVariant value;
+			bool erased;
+		};
+
+		QString m_file_name;
+		QVector<Change> m_changes;
+		qint64 m_compact_threshold = 256 * 1024;
+		qint64 m_journal_size = 0;
+		QThreadPool m_pool;
+
+		bool append();
+		bool replay(const QString &file_name);
+		QString rotatedFileName() const;
+	};
+
+} // namespace QDX
+
+#endif // QDX_JOURNALSTORAGE_H
@@ -0,0 +1,426 @@
+#include "MappedStorage.h"
+
+#include <QSaveFile>
+#include <QDataStream>
+#include <QBuffer>
+#include <QStringList>
+
+#include <cstring>
+
+static const quint32 MAPPED_MAGIC = 0x5144584D;
+static const quint32 MAPPED_VERSION = 1;
+
+enum MappedType : quint32 {
+	MappedBool,
+	MappedInt,
+	MappedLongLong,
+	MappedDouble,
+	MappedString,
+	MappedBytes,
+	MappedVariant
+};
+
+struct QDX::MappedStorage::Header
+{
+	quint32 magic;
+	quint32 version;
+	quint32 count;
+	quint32 reserved;
+};
+
+struct QDX::MappedStorage::Record
+{
+	quint32 key_offset;
+	quint32 key_length;
+	quint32 type;
+	quint32 value_length;
+	quint64 value;
+};
+
+QDX::MappedStorage::MappedStorage(const QString &file_name) : m_file(file_name)
+{
+
+}
+
+QDX::MappedStorage::~MappedStorage()
+{
+	this->close();
+}
+
+QString QDX::MappedStorage::fileName() const
+{
+	return m_file.fileName();
+}
+
+void QDX::MappedStorage::setFileName(const QString &file_name)
+{
+	this->close();
+	m_file.setFileName(file_name);
+}
+
+bool QDX::MappedStorage::open()
+{
+	this->close();
+	if (m_file.open(QIODevice::ReadOnly) == false) {
+		return false;
+	}
+	qint64 size = m_file.size();
+	if (size < qint64(sizeof(Header))) {
+		m_file.close();
+		return false;
+	}
+	const uchar *data = m_file.map(0, size);
+	if (data == nullptr) {
+		m_file.close();
+		return false;
+	}
+	Header header;
+	std::memcpy(&header, data, sizeof(Header));
+	if (header.magic != MAPPED_MAGIC || header.version != MAPPED_VERSION || qint64(sizeof(Header)) + qint64(header.count) * qint64(sizeof(Record)) > size) {
+		m_file.unmap(const_cast<uchar *>(data));
+		m_file.close();
+		return false;
+	}
+	m_data = data;
+	m_size = size;
+	m_count = header.count;
+	return true;
+}
+
+void QDX::MappedStorage::close()
+{
+	if (m_data) {
+		m_file.unmap(const_cast<uchar *>(m_data));
+		m_data = nullptr;
+	}
+	m_size = 0;
+	m_count = 0;
+	if (m_file.isOpen()) {
+		m_file.close();
+	}
+}
+
+bool QDX::MappedStorage::isOpen() const
+{
+	return m_data != nullptr;
+}
+
+int QDX::MappedStorage::count() const
+{
+	return int(m_count);
+}
+
+const QDX::MappedStorage::Record *QDX::MappedStorage::record(quint32 index) const
+{
+	return reinterpret_cast<const Record *>(m_data + sizeof(Header)) + index;
+}
+
+QString QDX::MappedStorage::key(const Record *record) const
+{
+	if (qint64(record->key_offset) + qint64(record->key_length) * 2 > m_size) {
+		return QString();
+	}
+	return QString::fromRawData(reinterpret_cast<const QChar *>(m_data + record->key_offset), int(record->key_length));
+}
+
+int QDX::MappedStorage::compare(const Record *record, const QString &path) const
+{
+	return QString::compare(this->key(record), path);
+}
+
+int QDX::MappedStorage::lowerBound(const QString &path) const
+{
+	quint32 low = 0, high = m_count;
+	while (low < high) {
+		quint32 middle = low + (high - low) / 2;
+		if (this->compare(this->record(middle), path) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return int(low);
+}
+
+int QDX::MappedStorage::find(const QString &path) const
+{
+	if (m_data == nullptr) {
+		return -1;
+	}
+	int index = this->lowerBound(path);
+	if (quint32(index) < m_count && this->compare(this->record(quint32(index)), path) == 0) {
+		return index;
+	}
+	return -1;
+}
+
+QVariant QDX::MappedStorage::read(const QString &path) const
+{
+	int index = this->find(path);
+	if (index < 0) {
+		return QVariant();
+	}
+	const Record *record = this->record(quint32(index));
+	switch (record->type) {
+		case MappedBool:
+			return QVariant(record->value != 0);
+		case MappedInt:
+			return QVariant(int(qint64(record->value)));
+		case MappedLongLong:
+			return QVariant(qint64(record->value));
+		case MappedDouble: {
+			double value;
+			std::memcpy(&value, &record->value, sizeof(double));
+			return QVariant(value);
+		}
+		default:
+			break;
+	}
+	qint64 length = record->type == MappedString ? qint64(record->value_length) * 2 : qint64(record->value_length);
+	if (qint64(record->value) + length > m_size) {
+		return QVariant();
+	}
+	const char *data = reinterpret_cast<const char *>(m_data + record->value);
+	switch (record->type) {
+		case MappedString:
+			return QVariant(QString(reinterpret_cast<const QChar *>(data), int(record->value_length)));
+		case MappedBytes:
+			return QVariant(QByteArray(data, int(length)));
+		case MappedVariant: {
+			QDataStream stream(QByteArray::fromRawData(data, int(length)));
+			stream.setVersion(QDataStream::Qt_5_6);
+			QVariant value;
+			stream >> value;
+			return value;
+		}
+		default:
+			break;
+	}
+	return QVariant();
+}
+
+const QDX::MappedStorage::Record *QDX::MappedStorage::lookup(const QString &path) const
+{
+	int index = this->find(path);
+	return index < 0 ? nullptr : this->record(quint32(index));
+}
+
+const char *QDX::MappedStorage::payload(const Record *record, qint64 length) const
+{
+	if (qint64(record->value) + length > m_size) {
+		return nullptr;
+	}
+	return reinterpret_cast<const char *>(m_data + record->value);
+}
+
+bool QDX::MappedStorage::readBool(const QString &path, bool &value) const
+{
+	const Record *record = this->lookup(path);
+	if (record == nullptr) {
+		return false;
+	}
+	if (record->type != MappedBool) {
+		return Storage::readBool(path, value);
+	}
+	value = record->value != 0;
+	return true;
+}
+
+bool QDX::MappedStorage::readInt(const QString &path, int &value) const
+{
+	const Record *record = this->lookup(path);
+	if (record == nullptr) {
+		return false;
+	}
+	if (record->type != MappedInt && record->type != MappedLongLong) {
+		return Storage::readInt(path, value);
+	}
+	value = int(qint64(record->value));
+	return true;
+}
+
+bool QDX::MappedStorage::readDouble(const QString &path, double &value) const
+{
+	const Record *record = this->lookup(path);
+	if (record == nullptr) {
+		return false;
+	}
+	if (record->type != MappedDouble) {
+		return Storage::readDouble(path, value);
+	}
+	std::memcpy(&value, &record->value, sizeof(double));
+	return true;
+}
+
+bool QDX::MappedStorage::readString(const QString &path, QString &value) const
+{
+	const Record *record = this->lookup(path);
+	if (record == nullptr) {
+		return false;
+	}
+	if (record->type != MappedString) {
+		return Storage::readString(path, value);
+	}
+	const char *data = this->payload(record, qint64(record->value_length) * 2);
+	if (data == nullptr) {
+		return false;
+	}
+	value = QString(reinterpret_cast<const QChar *>(data), int(record->value_length));
+	return true;
+}
+
+bool QDX::MappedStorage::readBytes(const QString &path, QByteArray &value) const
+{
+	const Record *record = this->lookup(path);
+	if (record == nullptr) {
+		return false;
+	}
+	if (record->type != MappedBytes) {
+		return Storage::readBytes(path, value);
+	}
+	const char *data = this->payload(record, qint64(record->value_length));
+	if (data == nullptr) {
+		return false;
+	}
+	value = QByteArray(data, int(record->value_length));
+	return true;
+}
+
+void QDX::MappedStorage::write(const QString &path, const QVariant &value)
+{
+	Q_UNUSED(path)
+	Q_UNUSED(value)
+}
+
+void QDX::MappedStorage::erase(const QString &path)
+{
+	Q_UNUSED(path)
+}
+
+QStringList QDX::MappedStorage::keys(const QString &prefix) const
+{
+	QStringList keys;
+	if (m_data == nullptr) {
+		return keys;
+	}
+	if (prefix.isEmpty()) {
+		keys.reserve(int(m_count));
+		for (quint32 i = 0; i < m_count; ++i) {
+			const QString key = this->key(this->record(i));
+			keys.append(QString(key.constData(), key.size()));
+		}
+		return keys;
+	}
+	const QString group = prefix + '/';
+	for (quint32 i = quint32(this->lowerBound(group)); i < m_count; ++i) {
+		const QString key = this->key(this->record(i));
+		if (key.startsWith(group) == false) {
+			break;
+		}
+		keys.append(key.mid(group.size()));
+	}
+	return keys;
+}
+
+static void alignData(QByteArray &data, int alignment)
+{
+	while (data.size() % alignment != 0) {
+		data.append('\0');
+	}
+}
+
+bool QDX::MappedStorage::create(const QString &file_name, const QHash<QString, QVariant> &values)
+{
+	QStringList paths = values.keys();
+	paths.sort();
+
+	QByteArray data(int(sizeof(Header) + sizeof(Record) * size_t(paths.size())), '\0');
+	QVector<Record> records;
+	records.reserve(paths.size());
+
+	for (const QString &path : qAsConst(paths)) {
+		const QVariant &value = values.find(path).value();
+		Record record = { 0, quint32(path.size()), MappedVariant, 0, 0 };
+
+		alignData(data, 2);
+		record.key_offset = quint32(data.size());
+		data.append(reinterpret_cast<const char *>(path.constData()), path.size() * 2);
+
+		switch (int(value.type())) {
+			case QVariant::Bool:
+				record.type = MappedBool;
+				record.value = value.toBool() ? 1 : 0;
+				break;
+			case QVariant::Int:
+				record.type = MappedInt;
+				record.value = quint64(qint64(value.toInt()));
+				break;
+			case QVariant::LongLong:
+				record.type = MappedLongLong;
+				record.value = quint64(value.toLongLong());
+				break;
+			case QVariant::Double: {
+				double number = value.toDouble();
+				record.type = MappedDouble;
+				std::memcpy(&record.value, &number, sizeof(double));
+				break;
+			}
+			case QVariant::String: {
+				const QString string = value.toString();
+				alignData(data, 2);
+				record.type = MappedString;
+				record.value = quint64(data.size());
+				record.value_length = quint32(string.size());
+				data.append(reinterpret_cast<const char *>(string.constData()), string.size() * 2);
+				break;
+			}
+			case QVariant::ByteArray: {
+				const QByteArray bytes = value.toByteArray();
+				record.type = MappedBytes;
+				record.value = quint64(data.size());
+				record.value_length = quint32(bytes.size());
+				data.append(bytes);
+				break;
+			}
+			default: {
+				QByteArray bytes;
+				QDataStream stream(&bytes, QIODevice::WriteOnly);
+				stream.setVersion(QDataStream::Qt_5_6);
+				stream << value;
+				record.type = MappedVariant;
+				record.value = quint64(data.size());
+				record.value_length = quint32(bytes.size());
+				data.append(bytes);
+				break;
+			}
+		}
+		records.append(record);
+	}
+
+	Header header = { MAPPED_MAGIC, MAPPED_VERSION, quint32(records.size()), 0 };
+	std::memcpy(data.data(), &header, sizeof(Header));
+	if (records.isEmpty() == false) {
+		std::memcpy(data.data() + sizeof(Header), records.constData(), sizeof(Record) * size_t(records.size()));
+	}
+
+	QSaveFile file(file_name);
+	if (file.open(QIODevice::WriteOnly) == false) {
+		return false;
+	}
+	if (file.write(data) != data.size()) {
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
+
+bool QDX::MappedStorage::create(const QString &file_name, const Storage &source)
+{
+	QHash<QString, QVariant> values;
+	const QStringList paths = source.keys();
+	values.reserve(paths.size());
+	for (const QString &path : paths) {
+		values.insert(path, source.read(path));
+	}
+	return create(file_name, values);
+}
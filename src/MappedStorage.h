@@ -0,0 +1,60 @@
+#ifndef QDX_MAPPEDSTORAGE_H
+#define QDX_MAPPEDSTORAGE_H
+
+#include <QFile>
+#include <QHash>
+
+#include "Storage.h"
+
+namespace QDX {
+
+	class MappedStorage : public Storage
+	{
+	public:
+		MappedStorage(const QString &file_name = QString());
+		virtual ~MappedStorage();
+
+		QString fileName() const;
+		void setFileName(const QString &file_name);
+
+		bool open();
+		void close();
+		bool isOpen() const;
+
+		int count() const;
+
+		QVariant read(const QString &path) const override;
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		QStringList keys(const QString &prefix = QString()) const override;
+
+		bool readBool(const QString &path, bool &value) const override;
+		bool readInt(const QString &path, int &value) const override;
+		bool readDouble(const QString &path, double &value) const override;
+		bool readString(const QString &path, QString &value) const override;
+		bool readBytes(const QString &path, QByteArray &value) const override;
+
+		static bool create(const QString &file_name, const QHash<QString, QVariant> &values);
+		static bool create(const QString &file_name, const Storage &source);
+
+	private:
+		struct Header;
+		struct Record;
+
+		QFile m_file;
+		const uchar *m_data = nullptr;
+		qint64 m_size = 0;
+		quint32 m_count = 0;
+
+		const Record *record(quint32 index) const;
+		QString key(const Record *record) const;
+		int find(const QString &path) const;
+		const Record *lookup(const QString &path) const;
+		const char *payload(const Record *record, qint64 length) const;
+		int lowerBound(const QString &path) const;
+		int compare(const Record *record, const QString &path) const;
+	};
+
+} // namespace QDX
+
+#endif // QDX_MAPPEDSTORAGE_H
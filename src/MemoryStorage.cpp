@@ -0,0 +1,166 @@
+#include "MemoryStorage.h"
+
+#include <QSet>
+
+QDX::MemoryStorage::MemoryStorage()
+{
+
+}
+
+QDX::MemoryStorage::MemoryStorage(const Values &values) : m_values(values)
+{
+
+}
+
+QDX::MemoryStorage::~MemoryStorage()
+{
+
+}
+
+QVariant QDX::MemoryStorage::read(const QString &path) const
+{
+	return m_values.value(path);
+}
+
+void QDX::MemoryStorage::write(const QString &path, const QVariant &value)
+{
+	m_values.insert(path, value);
+}
+
+void QDX::MemoryStorage::erase(const QString &path)
+{
+	if (path.isEmpty()) {
+		m_values.clear();
+		return;
+	}
+	m_values.remove(path);
+	const QString prefix = path + '/';
+	for (auto it = m_values.begin(); it != m_values.end(); ) {
+		if (it.key().startsWith(prefix)) {
+			it = m_values.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void QDX::MemoryStorage::eraseAll(const QStringList &paths)
+{
+	if (paths.size() == 1) {
+		this->erase(paths.first());
+		return;
+	}
+	QSet<QString> doomed;
+	doomed.reserve(paths.size());
+	for (const QString &path : paths) {
+		if (path.isEmpty()) {
+			m_values.clear();
+			return;
+		}
+		doomed.insert(path);
+	}
+	if (doomed.isEmpty()) {
+		return;
+	}
+	for (auto it = m_values.begin(); it != m_values.end(); ) {
+		bool erased = doomed.contains(it.key());
+		for (int i = it.key().lastIndexOf('/'); erased == false && i > 0; i = it.key().lastIndexOf('/', i - 1)) {
+			erased = doomed.contains(it.key().left(i));
+		}
+		if (erased) {
+			it = m_values.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+QStringList QDX::MemoryStorage::keys(const QString &prefix) const
+{
+	QStringList keys;
+	if (prefix.isEmpty()) {
+		keys.reserve(m_values.size());
+		for (auto it = m_values.constBegin(); it != m_values.constEnd(); ++it) {
+			keys.append(it.key());
+		}
+		return keys;
+	}
+	const int length = prefix.size() + 1;
+	for (auto it = m_values.constBegin(); it != m_values.constEnd(); ++it) {
+		if (it.key().size() > length && it.key().startsWith(prefix) && it.key().at(prefix.size()) == '/') {
+			keys.append(it.key().mid(length));
+		}
+	}
+	return keys;
+}
+
+const QVariant *QDX::MemoryStorage::find(const QString &path) const
+{
+	auto it = m_values.constFind(path);
+	return it == m_values.constEnd() ? nullptr : &it.value();
+}
+
+bool QDX::MemoryStorage::readBool(const QString &path, bool &value) const
+{
+	const QVariant *stored = this->find(path);
+	if (stored == nullptr) {
+		return false;
+	}
+	value = stored->toBool();
+	return true;
+}
+
+bool QDX::MemoryStorage::readInt(const QString &path, int &value) const
+{
+	const QVariant *stored = this->find(path);
+	if (stored == nullptr) {
+		return false;
+	}
+	value = stored->toInt();
+	return true;
+}
+
+bool QDX::MemoryStorage::readDouble(const QString &path, double &value) const
+{
+	const QVariant *stored = this->find(path);
+	if (stored == nullptr) {
+		return false;
+	}
+	value = stored->toDouble();
+	return true;
+}
+
+bool QDX::MemoryStorage::readString(const QString &path, QString &value) const
+{
+	const QVariant *stored = this->find(path);
+	if (stored == nullptr) {
+		return false;
+	}
+	value = stored->toString();
+	return true;
+}
+
+bool QDX::MemoryStorage::readBytes(const QString &path, QByteArray &value) const
+{
+	const QVariant *stored = this->find(path);
+	if (stored == nullptr) {
+		return false;
+	}
+	value = stored->toByteArray();
+	return true;
+}
+
+const QDX::MemoryStorage::Values &QDX::MemoryStorage::values() const
+{
+	return m_values;
+}
+
+void QDX::MemoryStorage::setValues(const Values &values)
+{
+	m_values = values;
+}
+
+void QDX::MemoryStorage::clear()
+{
+	m_values.clear();
+}
@@ -0,0 +1,43 @@
+#ifndef QDX_MEMORYSTORAGE_H
+#define QDX_MEMORYSTORAGE_H
+
+#include <QHash>
+
+#include "Storage.h"
+
+namespace QDX {
+
+	class MemoryStorage : public Storage
+	{
+	public:
+		typedef QHash<QString, QVariant> Values;
+
+		MemoryStorage();
+		MemoryStorage(const Values &values);
+		virtual ~MemoryStorage();
+
+		QVariant read(const QString &path) const override;
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		void eraseAll(const QStringList &paths) override;
+		QStringList keys(const QString &prefix = QString()) const override;
+
+		bool readBool(const QString &path, bool &value) const override;
+		bool readInt(const QString &path, int &value) const override;
+		bool readDouble(const QString &path, double &value) const override;
+		bool readString(const QString &path, QString &value) const override;
+		bool readBytes(const QString &path, QByteArray &value) const override;
+
+		const Values &values() const;
+		void setValues(const Values &values);
+		void clear();
+
+	protected:
+		Values m_values;
+
+		virtual const QVariant *find(const QString &path) const;
+	};
+
+} // namespace QDX
+
+#endif // QDX_MEMORYSTORAGE_H
@@ -0,0 +1,144 @@
+#include "PreloadStorage.h"
+#include "SnapshotStorage.h"
+
+#include <QRunnable>
+#include <QFile>
+
+class QDX::PreloadStorage::Task : public QRunnable
+{
+public:
+	Task(PreloadStorage &storage) : m_storage(storage)
+	{
+
+	}
+
+	void run() override
+	{
+		m_storage.m_result = m_storage.m_loader ? m_storage.m_loader(m_storage.m_result_values) : true;
+		m_storage.m_done.storeRelease(1);
+	}
+
+private:
+	PreloadStorage &m_storage;
+};
+
+QDX::PreloadStorage::PreloadStorage(const Loader &loader, const Saver &saver) : m_loader(loader), m_saver(saver)
+{
+	m_pool.setMaxThreadCount(1);
+}
+
+QDX::PreloadStorage::~PreloadStorage()
+{
+	m_pool.waitForDone();
+}
+
+void QDX::PreloadStorage::start()
+{
+	if (m_started) {
+		return;
+	}
+	m_started = true;
+	m_pool.start(new Task(*this));
+}
+
+bool QDX::PreloadStorage::wait() const
+{
+	if (m_ready) {
+		return m_loaded;
+	}
+	PreloadStorage *self = const_cast<PreloadStorage *>(this);
+	if (m_started == false) {
+		self->start();
+	}
+	m_pool.waitForDone();
+	m_ready = true;
+	m_loaded = m_result;
+	self->m_values.swap(self->m_result_values);
+	self->m_result_values.clear();
+	return m_loaded;
+}
+
+bool QDX::PreloadStorage::isReady() const
+{
+	return m_ready || (m_done.loadAcquire() != 0);
+}
+
+QVariant QDX::PreloadStorage::read(const QString &path) const
+{
+	this->wait();
+	return MemoryStorage::read(path);
+}
+
+const QVariant *QDX::PreloadStorage::find(const QString &path) const
+{
+	this->wait();
+	return MemoryStorage::find(path);
+}
+
+void QDX::PreloadStorage::write(const QString &path, const QVariant &value)
+{
+	this->wait();
+	MemoryStorage::write(path, value);
+}
+
+void QDX::PreloadStorage::erase(const QString &path)
+{
+	this->wait();
+	MemoryStorage::erase(path);
+}
+
+void QDX::PreloadStorage::eraseAll(const QStringList &paths)
+{
+	this->wait();
+	MemoryStorage::eraseAll(paths);
+}
+
+QStringList QDX::PreloadStorage::keys(const QString &prefix) const
+{
+	this->wait();
+	return MemoryStorage::keys(prefix);
+}
+
+bool QDX::PreloadStorage::sync()
+{
+	this->wait();
+	return m_saver ? m_saver(m_values) : true;
+}
+
+QDX::PreloadStorage::Loader QDX::PreloadStorage::settingsLoader(const QString &file_name, QSettings::Format format)
+{
+	return [file_name, format](Values &values) {
+		QSettings settings(file_name, format);
+		for (const QString &key : settings.allKeys()) {
+			values.insert(key, settings.value(key));
+		}
+		return settings.status() == QSettings::NoError;
+	};
+}
+
+QDX::PreloadStorage::Saver QDX::PreloadStorage::settingsSaver(const QString &file_name, QSettings::Format format)
+{
+	return [file_name, format](const Values &values) {
+		QSettings settings(file_name, format);
+		settings.clear();
+		for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+			settings.setValue(it.key(), it.value());
+		}
+		settings.sync();
+		return settings.status() == QSettings::NoError;
+	};
+}
+
+QDX::PreloadStorage::Loader QDX::PreloadStorage::snapshotLoader(const QString &file_name)
+{
+	return [file_name](Values &values) {
+		return QFile::exists(file_name) == false || SnapshotStorage::readFile(file_name, values);
+	};
+}
+
+QDX::PreloadStorage::Saver QDX::PreloadStorage::snapshotSaver(const QString &file_name)
+{
+	return [file_name](const Values &values) {
+		return SnapshotStorage::writeFile(file_name, values);
+	};
+}
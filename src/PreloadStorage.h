@@ -0,0 +1,61 @@
+#ifndef QDX_PRELOADSTORAGE_H
+#define QDX_PRELOADSTORAGE_H
+
+#include <QSettings>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+#include <functional>
+
+#include "MemoryStorage.h"
+
+namespace QDX {
+
+	class PreloadStorage : public MemoryStorage
+	{
+	public:
+		typedef std::function<bool (Values &values)> Loader;
+		typedef std::function<bool (const Values &values)> Saver;
+
+		PreloadStorage(const Loader &loader, const Saver &saver = Saver());
+		virtual ~PreloadStorage();
+
+		void start();
+		bool wait() const;
+		bool isReady() const;
+
+		QVariant read(const QString &path) const override;
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		void eraseAll(const QStringList &paths) override;
+		QStringList keys(const QString &prefix = QString()) const override;
+
+		bool sync() override;
+
+		static Loader settingsLoader(const QString &file_name, QSettings::Format format = QSettings::IniFormat);
+		static Saver settingsSaver(const QString &file_name, QSettings::Format format = QSettings::IniFormat);
+
+		static Loader snapshotLoader(const QString &file_name);
+		static Saver snapshotSaver(const QString &file_name);
+
+	protected:
+		const QVariant *find(const QString &path) const override;
+
+	private:
+		class Task;
+
+		Loader m_loader;
+		Saver m_saver;
+
+		mutable QThreadPool m_pool;
+		mutable bool m_started = false;
+		mutable bool m_ready = false;
+		mutable bool m_loaded = false;
+		bool m_result = false;
+		QAtomicInt m_done;
+		Values m_result_values;
+	};
+
+} // namespace QDX
+
+#endif // QDX_PRELOADSTORAGE_H
@@ -0,0 +1,290 @@
+#include "ProfileStorage.h"
+
+QDX::ProfileStorage::ProfileStorage(Storage &base) : m_base(base)
+{
+
+}
+
+QDX::ProfileStorage::~ProfileStorage()
+{
+
+}
+
+QDX::Storage &QDX::ProfileStorage::base() const
+{
+	return m_base;
+}
+
+QString QDX::ProfileStorage::profile() const
+{
+	return m_profile;
+}
+
+void QDX::ProfileStorage::setProfile(const QString &name)
+{
+	m_profile = name;
+	m_erased = this->erasedPaths(name);
+}
+
+QStringList QDX::ProfileStorage::profiles() const
+{
+	QStringList profiles;
+	for (const QString &key : m_base.keys(QLatin1String(PROFILES))) {
+		const QString name = key.left(key.indexOf('/'));
+		if (name.isEmpty() == false && profiles.contains(name) == false) {
+			profiles.append(name);
+		}
+	}
+	profiles.sort();
+	return profiles;
+}
+
+void QDX::ProfileStorage::removeProfile(const QString &name)
+{
+	if (name.isEmpty()) {
+		return;
+	}
+	m_base.erase(QLatin1String(PROFILES) + '/' + name);
+	if (name == m_profile) {
+		m_erased.clear();
+	}
+}
+
+QStringList QDX::ProfileStorage::differences(const QString &from, const QString &to) const
+{
+	QStringList differences;
+	if (from == to) {
+		return differences;
+	}
+
+	const QSet<QString> from_erased = from == m_profile ? m_erased : this->erasedPaths(from);
+	const QSet<QString> to_erased = to == m_profile ? m_erased : this->erasedPaths(to);
+
+	QSet<QString> paths;
+	for (const QString &name : { from, to }) {
+		if (name.isEmpty()) {
+			continue;
+		}
+		for (const QString &key : m_base.keys(this->valuesPath(name))) {
+			paths.insert(key);
+		}
+	}
+	for (const QSet<QString> *erased : { &from_erased, &to_erased }) {
+		for (const QString &path : *erased) {
+			if (path.isEmpty()) {
+				for (const QString &key : m_base.keys()) {
+					if (isProfilePath(key) == false) {
+						paths.insert(key);
+					}
+				}
+				continue;
+			}
+			paths.insert(path);
+			for (const QString &key : m_base.keys(path)) {
+				paths.insert(path + '/' + key);
+			}
+		}
+	}
+
+	for (const QString &path : qAsConst(paths)) {
+		if (this->isShared(path)) {
+			continue;
+		}
+		if (this->profileValue(from, from_erased, path) != this->profileValue(to, to_erased, path)) {
+			differences.append(path);
+		}
+	}
+	return differences;
+}
+
+void QDX::ProfileStorage::addSharedPrefix(const QString &prefix)
+{
+	if (prefix.isEmpty() == false && m_shared.contains(prefix) == false) {
+		m_shared.append(prefix);
+	}
+}
+
+bool QDX::ProfileStorage::isShared(const QString &path) const
+{
+	for (const QString &prefix : m_shared) {
+		if (path.startsWith(prefix)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool QDX::ProfileStorage::isInherited(const QString &path) const
+{
+	if (m_profile.isEmpty() || this->isShared(path) || isErased(m_erased, path)) {
+		return false;
+	}
+	return m_base.read(this->valuesPath(m_profile) + '/' + path).isValid() == false;
+}
+
+QVariant QDX::ProfileStorage::read(const QString &path) const
+{
+	return this->profileValue(m_profile, m_erased, path);
+}
+
+void QDX::ProfileStorage::write(const QString &path, const QVariant &value)
+{
+	if (m_profile.isEmpty() || this->isShared(path)) {
+		m_base.write(path, value);
+		return;
+	}
+	if (m_erased.remove(path)) {
+		this->storeErased();
+	}
+	const QString override_path = this->valuesPath(m_profile) + '/' + path;
+	if (isErased(m_erased, path) == false && m_base.read(path) == value) {
+		if (m_base.read(override_path).isValid()) {
+			m_base.erase(override_path);
+		}
+		return;
+	}
+	m_base.write(override_path, value);
+}
+
+void QDX::ProfileStorage::erase(const QString &path)
+{
+	if (m_profile.isEmpty() || this->isShared(path)) {
+		m_base.erase(path);
+		return;
+	}
+	m_base.erase(path.isEmpty() ? this->valuesPath(m_profile) : this->valuesPath(m_profile) + '/' + path);
+	m_erased.insert(path);
+	this->storeErased();
+}
+
+QStringList QDX::ProfileStorage::keys(const QString &prefix) const
+{
+	if (m_profile.isEmpty() && prefix.isEmpty() == false) {
+		return m_base.keys(prefix);
+	}
+	const QString group = prefix.isEmpty() ? QString() : prefix + '/';
+	QStringList keys;
+	QSet<QString> seen;
+	for (const QString &key : m_base.keys(prefix)) {
+		const QString path = group + key;
+		if (isProfilePath(path) || (isErased(m_erased, path) && this->isShared(path) == false)) {
+			continue;
+		}
+		keys.append(key);
+		seen.insert(key);
+	}
+	if (m_profile.isEmpty()) {
+		return keys;
+	}
+	for (const QString &key : m_base.keys(this->valuesPath(m_profile) + (prefix.isEmpty() ? QString() : '/' + prefix))) {
+		if (seen.contains(key) == false) {
+			keys.append(key);
+		}
+	}
+	return keys;
+}
+
+bool QDX::ProfileStorage::sync()
+{
+	return m_base.sync();
+}
+
+bool QDX::ProfileStorage::rewrite()
+{
+	return m_base.rewrite();
+}
+
+qint64 QDX::ProfileStorage::storedSize() const
+{
+	return m_base.storedSize();
+}
+
+qint64 QDX::ProfileStorage::compact(const KeyFilter &keep, Storage *archive, int *removed)
+{
+	static const QLatin1String profiles(PROFILES);
+	static const QLatin1String values("/values/");
+	return m_base.compact([&keep](const QString &path) {
+		if (isProfilePath(path) == false) {
+			return keep(path);
+		}
+		int name_end = path.indexOf('/', profiles.size() + 1);
+		if (name_end < 0 || path.midRef(name_end).startsWith(values) == false) {
+			return true;
+		}
+		return keep(path.mid(name_end + values.size()));
+	}, archive, removed);
+}
+
+QString QDX::ProfileStorage::valuesPath(const QString &name) const
+{
+	return QLatin1String(PROFILES) + '/' + name + QLatin1String("/values");
+}
+
+QString QDX::ProfileStorage::erasedPath(const QString &name) const
+{
+	return QLatin1String(PROFILES) + '/' + name + QLatin1String("/erased");
+}
+
+QSet<QString> QDX::ProfileStorage::erasedPaths(const QString &name) const
+{
+	QSet<QString> erased;
+	if (name.isEmpty()) {
+		return erased;
+	}
+	for (const QString &path : m_base.read(this->erasedPath(name)).toStringList()) {
+		erased.insert(path);
+	}
+	return erased;
+}
+
+QVariant QDX::ProfileStorage::profileValue(const QString &name, const QSet<QString> &erased, const QString &path) const
+{
+	if (name.isEmpty() || this->isShared(path)) {
+		return m_base.read(path);
+	}
+	QVariant value = m_base.read(this->valuesPath(name) + '/' + path);
+	if (value.isValid()) {
+		return value;
+	}
+	if (isErased(erased, path)) {
+		return QVariant();
+	}
+	return m_base.read(path);
+}
+
+void QDX::ProfileStorage::storeErased()
+{
+	if (m_erased.isEmpty()) {
+		m_base.erase(this->erasedPath(m_profile));
+		return;
+	}
+	QStringList erased;
+	erased.reserve(m_erased.size());
+	for (const QString &path : qAsConst(m_erased)) {
+		erased.append(path);
+	}
+	erased.sort();
+	m_base.write(this->erasedPath(m_profile), erased);
+}
+
+bool QDX::ProfileStorage::isErased(const QSet<QString> &erased, const QString &path)
+{
+	if (erased.isEmpty()) {
+		return false;
+	}
+	if (erased.contains(QString()) || erased.contains(path)) {
+		return true;
+	}
+	for (int i = path.indexOf('/'); i >= 0; i = path.indexOf('/', i + 1)) {
+		if (erased.contains(path.left(i))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool QDX::ProfileStorage::isProfilePath(const QString &path)
+{
+	static const QLatin1String profiles(PROFILES);
+	return path.startsWith(profiles) && (path.size() == profiles.size() || path.at(profiles.size()) == '/');
+}
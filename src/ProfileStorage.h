@@ -0,0 +1,61 @@
+#ifndef QDX_PROFILESTORAGE_H
+#define QDX_PROFILESTORAGE_H
+
+#include <QSet>
+
+#include "Storage.h"
+
+namespace QDX {
+
+	class ProfileStorage : public Storage
+	{
+	public:
+		ProfileStorage(Storage &base);
+		virtual ~ProfileStorage();
+
+		static constexpr const char* PROFILES = "__profiles";
+
+		Storage &base() const;
+
+		QString profile() const;
+		void setProfile(const QString &name);
+
+		QStringList profiles() const;
+		void removeProfile(const QString &name);
+
+		QStringList differences(const QString &from, const QString &to) const;
+
+		void addSharedPrefix(const QString &prefix);
+		bool isShared(const QString &path) const;
+		bool isInherited(const QString &path) const;
+
+		QVariant read(const QString &path) const override;
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		QStringList keys(const QString &prefix = QString()) const override;
+
+		bool sync() override;
+		bool rewrite() override;
+		qint64 storedSize() const override;
+
+		qint64 compact(const KeyFilter &keep, Storage *archive = nullptr, int *removed = nullptr) override;
+
+	private:
+		Storage &m_base;
+		QString m_profile;
+		QSet<QString> m_erased;
+		QStringList m_shared;
+
+		QString valuesPath(const QString &name) const;
+		QString erasedPath(const QString &name) const;
+		QSet<QString> erasedPaths(const QString &name) const;
+		QVariant profileValue(const QString &name, const QSet<QString> &erased, const QString &path) const;
+		void storeErased();
+
+		static bool isErased(const QSet<QString> &erased, const QString &path);
+		static bool isProfilePath(const QString &path);
+	};
+
+} // namespace QDX
+
+#endif // QDX_PROFILESTORAGE_H
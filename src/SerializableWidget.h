@@ -2,8 +2,9 @@
 #define QDX_SERIALIZABLEWIDGET_H
 
 #include <QWidget>
+#include <QSettings>
 
-class QSettings;
+#include "Storage.h"
 
 namespace QDX {
 
@@ -14,8 +15,31 @@ namespace QDX {
 		using QWidget::QWidget;
 		virtual ~SerializableWidget() { }
 
-		virtual void save(const QString &key, QSettings &settings) = 0;
-		virtual void load(const QString &key, const QSettings &settings) = 0;
+		virtual void save(const QString &key, QSettings &settings)
+		{
+			Q_UNUSED(key)
+			Q_UNUSED(settings)
+		}
+
+		virtual void load(const QString &key, const QSettings &settings)
+		{
+			Q_UNUSED(key)
+			Q_UNUSED(settings)
+		}
+
+		virtual void save(const QString &key, Storage &storage)
+		{
+			if (QSettings *settings = storage.settings()) {
+				this->save(storage.path(key), *settings);
+			}
+		}
+
+		virtual void load(const QString &key, const Storage &storage)
+		{
+			if (QSettings *settings = storage.settings()) {
+				this->load(storage.path(key), *settings);
+			}
+		}
 	};
 
 }
@@ -0,0 +1,461 @@
+#include "SerializationPlan.h"
+
+#include <QEvent>
+#include <QDynamicPropertyChangeEvent>
+#include <QTabWidget>
+#include <QStackedWidget>
+#include <QMenu>
+#include <QDockWidget>
+#include <QSplitter>
+#include <QAction>
+#include <QActionGroup>
+#include <QComboBox>
+#include <QAbstractItemModel>
+#include <QMetaMethod>
+
+QDX::SerializationPlan::SerializationPlan(QObject *root, QObject *parent) : QObject(parent), m_root(root)
+{
+
+}
+
+QDX::SerializationPlan::~SerializationPlan()
+{
+	this->release();
+}
+
+QObject *QDX::SerializationPlan::root() const
+{
+	return m_root;
+}
+
+bool QDX::SerializationPlan::isValid() const
+{
+	return m_valid && m_revision == WidgetSerializer::handlersRevision();
+}
+
+void QDX::SerializationPlan::clear()
+{
+	this->release();
+	m_entries.clear();
+	m_pages.clear();
+	m_skipped = Skipped();
+	m_node_count = 0;
+	m_page_fingerprints.clear();
+	m_entry_fingerprints.clear();
+	m_entry_indexes.clear();
+	m_member_indexes.clear();
+	m_nodes.clear();
+	this->resetFingerprints();
+}
+
+void QDX::SerializationPlan::compile()
+{
+	this->build(nullptr);
+}
+
+bool QDX::SerializationPlan::bind(const PlanTemplate &plan_template)
+{
+	if (plan_template.revision != WidgetSerializer::handlersRevision() || plan_template.include_unhandled != m_include_unhandled) {
+		this->clear();
+		m_valid = false;
+		return false;
+	}
+	return this->build(&plan_template);
+}
+
+bool QDX::SerializationPlan::build(const PlanTemplate *plan_template)
+{
+	this->clear();
+	m_valid = false;
+	if (m_root == nullptr) {
+		return false;
+	}
+	connect(m_root.data(), &QObject::destroyed, this, &SerializationPlan::invalidate, Qt::UniqueConnection);
+	m_revision = WidgetSerializer::handlersRevision();
+	m_current_page = -1;
+	m_template = plan_template;
+	m_cursor = 0;
+	bool matched = this->compileCascade(m_root) && (m_template == nullptr || m_cursor == m_template->nodes.size());
+	m_template = nullptr;
+	if (matched == false) {
+		m_visited.clear();
+		this->clear();
+		return false;
+	}
+	if (m_watching) {
+		for (QObject *object : qAsConst(m_visited)) {
+			this->watch(object);
+		}
+	}
+	m_visited.clear();
+	if (m_fingerprinting) {
+		this->bindFingerprints();
+	}
+	m_valid = true;
+	return true;
+}
+
+bool QDX::SerializationPlan::record(QObject *object, int flags)
+{
+	if (m_template == nullptr) {
+		m_nodes.append({ object->metaObject(), object->objectName(), object->children().size(), flags });
+		return true;
+	}
+	if (m_cursor >= m_template->nodes.size()) {
+		return false;
+	}
+	const PlanTemplate::Node &node = m_template->nodes.at(m_cursor++);
+	return node.type == object->metaObject() && node.flags == flags && node.children == object->children().size() && node.name == object->objectName();
+}
+
+QSharedPointer<const QDX::PlanTemplate> QDX::SerializationPlan::createTemplate() const
+{
+	if (this->isValid() == false || m_nodes.isEmpty()) {
+		return QSharedPointer<const PlanTemplate>();
+	}
+	PlanTemplate *plan_template = new PlanTemplate();
+	plan_template->nodes = m_nodes;
+	plan_template->handlers.reserve(m_entries.size());
+	for (const Entry &entry : m_entries) {
+		plan_template->handlers.append(entry.handler);
+	}
+	plan_template->include_unhandled = m_include_unhandled;
+	plan_template->revision = m_revision;
+	return QSharedPointer<const PlanTemplate>(plan_template);
+}
+
+const QVector<QDX::SerializationPlan::Entry> &QDX::SerializationPlan::entries() const
+{
+	return m_entries;
+}
+
+const QVector<QDX::SerializationPlan::Page> &QDX::SerializationPlan::pages() const
+{
+	return m_pages;
+}
+
+const QDX::SerializationPlan::Skipped &QDX::SerializationPlan::skipped() const
+{
+	return m_skipped;
+}
+
+int QDX::SerializationPlan::nodeCount() const
+{
+	return m_node_count;
+}
+
+bool QDX::SerializationPlan::fingerprinting() const
+{
+	return m_fingerprinting;
+}
+
+void QDX::SerializationPlan::setFingerprinting(bool fingerprinting)
+{
+	if (m_fingerprinting == fingerprinting) {
+		return;
+	}
+	m_fingerprinting = fingerprinting;
+	this->invalidate();
+}
+
+bool QDX::SerializationPlan::includeUnhandled() const
+{
+	return m_include_unhandled;
+}
+
+void QDX::SerializationPlan::setIncludeUnhandled(bool include_unhandled)
+{
+	if (m_include_unhandled == include_unhandled) {
+		return;
+	}
+	m_include_unhandled = include_unhandled;
+	this->invalidate();
+}
+
+bool QDX::SerializationPlan::watching() const
+{
+	return m_watching;
+}
+
+void QDX::SerializationPlan::setWatching(bool watching)
+{
+	if (m_watching == watching) {
+		return;
+	}
+	m_watching = watching;
+	this->invalidate();
+}
+
+bool QDX::SerializationPlan::isEntryUnchanged(int entry, const QString &group) const
+{
+	if (m_saved == false || entry < 0 || entry >= m_entry_fingerprints.size() || m_saved_group != group) {
+		return false;
+	}
+	const Fingerprint &fingerprint = m_entry_fingerprints.at(entry);
+	return fingerprint.trackable && fingerprint.changed <= m_saved_clock;
+}
+
+bool QDX::SerializationPlan::isPageUnchanged(int page, const QString &group) const
+{
+	if (m_saved == false || page < 0 || page >= m_page_fingerprints.size() || m_saved_group != group) {
+		return false;
+	}
+	const Fingerprint &fingerprint = m_page_fingerprints.at(page);
+	return fingerprint.trackable && fingerprint.changed <= m_saved_clock;
+}
+
+void QDX::SerializationPlan::markSaved(const QString &group)
+{
+	m_saved = true;
+	m_saved_group = group;
+	m_saved_clock = m_clock;
+}
+
+void QDX::SerializationPlan::resetFingerprints()
+{
+	m_saved = false;
+	m_saved_group.clear();
+}
+
+void QDX::SerializationPlan::bindFingerprints()
+{
+	const QMetaMethod slot = this->metaObject()->method(this->metaObject()->indexOfSlot("changed()"));
+	for (int i = 0; i < m_entries.size(); ++i) {
+		const Entry &entry = m_entries.at(i);
+		Fingerprint &fingerprint = m_entry_fingerprints[i];
+		fingerprint.trackable = entry.handler && entry.handler->notifiers.isEmpty() == false;
+		if (fingerprint.trackable == false) {
+			for (int page = fingerprint.parent; page >= 0; page = m_page_fingerprints.at(page).parent) {
+				m_page_fingerprints[page].trackable = false;
+			}
+			continue;
+		}
+		for (const QMetaMethod &notifier : entry.handler->notifiers) {
+			connect(entry.object, notifier, this, slot);
+		}
+		m_entry_indexes.insert(entry.object, i);
+		this->bindMembers(entry.object, i, slot);
+	}
+}
+
+void QDX::SerializationPlan::bindMembers(QObject *object, int entry, const QMetaMethod &slot)
+{
+	if (QSplitter *splitter = qobject_cast<QSplitter *>(object)) {
+		splitter->installEventFilter(this);
+		m_member_indexes.insert(splitter, entry);
+		for (int i = 0; i < splitter->count(); ++i) {
+			QWidget *widget = splitter->widget(i);
+			widget->installEventFilter(this);
+			m_member_indexes.insert(widget, entry);
+			m_watched.append(widget);
+		}
+	} else if (QActionGroup *group = qobject_cast<QActionGroup *>(object)) {
+		const QMetaMethod toggled = QMetaMethod::fromSignal(&QAction::toggled);
+		for (QAction *action : group->actions()) {
+			connect(action, toggled, this, slot);
+			m_member_indexes.insert(action, entry);
+			m_watched.append(action);
+		}
+	} else if (QComboBox *combo = qobject_cast<QComboBox *>(object)) {
+		QAbstractItemModel *model = combo->model();
+		if (model == nullptr) {
+			return;
+		}
+		for (const QMetaMethod &notifier : { QMetaMethod::fromSignal(&QAbstractItemModel::rowsInserted), QMetaMethod::fromSignal(&QAbstractItemModel::rowsRemoved), QMetaMethod::fromSignal(&QAbstractItemModel::dataChanged), QMetaMethod::fromSignal(&QAbstractItemModel::modelReset) }) {
+			connect(model, notifier, this, slot, Qt::UniqueConnection);
+		}
+		m_member_indexes.insertMulti(model, entry);
+		m_watched.append(model);
+	}
+}
+
+void QDX::SerializationPlan::changed()
+{
+	QObject *sender = this->sender();
+	auto found = m_entry_indexes.constFind(sender);
+	if (found != m_entry_indexes.constEnd()) {
+		this->touch(found.value());
+	}
+	for (found = m_member_indexes.constFind(sender); found != m_member_indexes.constEnd() && found.key() == sender; ++found) {
+		this->touch(found.value());
+	}
+}
+
+void QDX::SerializationPlan::touch(int entry)
+{
+	Fingerprint &fingerprint = m_entry_fingerprints[entry];
+	fingerprint.changed = ++m_clock;
+	for (int page = fingerprint.parent; page >= 0; page = m_page_fingerprints.at(page).parent) {
+		m_page_fingerprints[page].changed = m_clock;
+	}
+}
+
+void QDX::SerializationPlan::invalidate()
+{
+	if (m_valid == false) {
+		return;
+	}
+	m_valid = false;
+	m_entries.clear();
+	m_pages.clear();
+	m_page_fingerprints.clear();
+	m_entry_fingerprints.clear();
+	m_entry_indexes.clear();
+	m_member_indexes.clear();
+	m_nodes.clear();
+	this->resetFingerprints();
+	emit invalidated();
+}
+
+bool QDX::SerializationPlan::eventFilter(QObject *watched, QEvent *event)
+{
+	switch (event->type()) {
+		case QEvent::ChildAdded:
+		case QEvent::ChildRemoved:
+			this->invalidate();
+			break;
+		case QEvent::DynamicPropertyChange: {
+			const QByteArray &name = static_cast<QDynamicPropertyChangeEvent *>(event)->propertyName();
+			if (name == WidgetSerializer::SERIALIZABLE || name == WidgetSerializer::CASCADABLE) {
+				this->invalidate();
+			}
+			break;
+		}
+		case QEvent::Resize:
+		case QEvent::ChildPolished:
+		case QEvent::LayoutRequest: {
+			auto found = m_member_indexes.constFind(watched);
+			if (found != m_member_indexes.constEnd() && (event->type() == QEvent::Resize || qobject_cast<QSplitter *>(watched))) {
+				this->touch(found.value());
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	return QObject::eventFilter(watched, event);
+}
+
+void QDX::SerializationPlan::watch(QObject *object)
+{
+	object->installEventFilter(this);
+	connect(object, &QObject::objectNameChanged, this, &SerializationPlan::invalidate, Qt::UniqueConnection);
+	m_watched.append(object);
+}
+
+void QDX::SerializationPlan::release()
+{
+	for (const QPointer<QObject> &object : qAsConst(m_watched)) {
+		if (object) {
+			object->removeEventFilter(this);
+			disconnect(object, nullptr, this, nullptr);
+		}
+	}
+	m_watched.clear();
+}
+
+bool QDX::SerializationPlan::compileCascade(QObject *object)
+{
+	m_visited.append(object);
+	++m_node_count;
+
+	int flags = 0;
+	QWidget *widget = qobject_cast<QWidget *>(object);
+	if (qobject_cast<QDockWidget *>(object) || qobject_cast<QStackedWidget *>(object->parent()) || (widget && widget->isWindow() && object != m_root)) {
+		flags |= PlanTemplate::Page;
+	}
+
+	QSharedPointer<const WidgetSerializer::TypeHandler> handler;
+	if (m_template) {
+		if (m_cursor < m_template->nodes.size() && (m_template->nodes.at(m_cursor).flags & PlanTemplate::Entry)) {
+			handler = m_template->handlers.at(m_entries.size());
+			flags |= PlanTemplate::Entry;
+		}
+	} else {
+		handler = WidgetSerializer::findHandler(object->metaObject());
+		if ((handler || m_include_unhandled) && object->objectName().isEmpty() == false) {
+			flags |= PlanTemplate::Entry;
+		}
+	}
+
+	QVariant cascadable = object->property(WidgetSerializer::CASCADABLE);
+	if (cascadable.isValid() && cascadable.toBool() == false) {
+		flags |= PlanTemplate::Uncascadable;
+	}
+
+	if (this->record(object, flags) == false) {
+		return false;
+	}
+
+	int page = -1;
+	int parent_page = m_current_page;
+	if (flags & PlanTemplate::Page) {
+		page = m_pages.size();
+		m_pages.append({ object, m_entries.size(), m_entries.size() });
+		m_page_fingerprints.append({ parent_page, true, 0 });
+		m_current_page = page;
+	}
+
+	if (flags & PlanTemplate::Entry) {
+		m_entries.append({ object, handler, object->objectName() });
+		m_entry_fingerprints.append({ m_current_page, true, 0 });
+	}
+
+	bool matched = true;
+	if (qobject_cast<QMenu *>(object)) {
+		++m_skipped.menu;
+	} else if (flags & PlanTemplate::Uncascadable) {
+		++m_skipped.cascadable;
+	} else {
+		matched = this->compileChildren(object);
+	}
+
+	if (page >= 0) {
+		m_pages[page].end = m_entries.size();
+		m_current_page = parent_page;
+	}
+	return matched;
+}
+
+bool QDX::SerializationPlan::compileChildren(QObject *object)
+{
+	if (object == nullptr) {
+		return true;
+	}
+	if (QTabWidget *tabs = qobject_cast<QTabWidget *>(object)) {
+		QStackedWidget *stack = tabs->findChild<QStackedWidget *>("qt_tabwidget_stackedwidget");
+		if (stack == nullptr) {
+			return true;
+		}
+		m_visited.append(stack);
+		if (this->record(stack, PlanTemplate::Internal) == false) {
+			return false;
+		}
+		return this->compileChildren(stack);
+	}
+	QVariant serializable;
+	const QObjectList &children = object->children();
+	for (int i = 0; i < children.size(); ++i) {
+		QObject *child = children.at(i);
+		if (child->objectName().startsWith("qt_")) {
+			++m_skipped.internal;
+			if (this->record(child, PlanTemplate::Internal) == false) {
+				return false;
+			}
+			continue;
+		}
+		serializable = child->property(WidgetSerializer::SERIALIZABLE);
+		if (serializable.isValid() && serializable.toBool() == false) {
+			++m_skipped.serializable;
+			m_visited.append(child);
+			if (this->record(child, PlanTemplate::Unserializable) == false) {
+				return false;
+			}
+			continue;
+		}
+		if (this->compileCascade(child) == false) {
+			return false;
+		}
+	}
+	return true;
+}
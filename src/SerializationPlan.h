@@ -0,0 +1,158 @@
+#ifndef QDX_SERIALIZATIONPLAN_H
+#define QDX_SERIALIZATIONPLAN_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QHash>
+
+#include "WidgetSerializer.h"
+
+namespace QDX {
+
+	struct PlanTemplate
+	{
+		enum NodeFlag
+		{
+			Entry = 0x01,
+			Page = 0x02,
+			Internal = 0x04,
+			Unserializable = 0x08,
+			Uncascadable = 0x10
+		};
+
+		struct Node
+		{
+			const QMetaObject *type;
+			QString name;
+			int children;
+			int flags;
+		};
+
+		QVector<Node> nodes;
+		QVector<QSharedPointer<const WidgetSerializer::TypeHandler>> handlers;
+		bool include_unhandled = false;
+		int revision = 0;
+	};
+
+	class SerializationPlan : public QObject
+	{
+		Q_OBJECT
+	public:
+		struct Entry
+		{
+			QObject *object;
+			QSharedPointer<const WidgetSerializer::TypeHandler> handler;
+			QString key;
+		};
+
+		struct Page
+		{
+			QObject *object;
+			int begin;
+			int end;
+		};
+
+		struct Skipped
+		{
+			int internal = 0;
+			int serializable = 0;
+			int cascadable = 0;
+			int menu = 0;
+		};
+
+		SerializationPlan(QObject *root, QObject *parent = nullptr);
+		virtual ~SerializationPlan();
+
+		QObject *root() const;
+
+		bool isValid() const;
+		void compile();
+
+		bool bind(const PlanTemplate &plan_template);
+		QSharedPointer<const PlanTemplate> createTemplate() const;
+
+		const QVector<Entry> &entries() const;
+		const QVector<Page> &pages() const;
+		const Skipped &skipped() const;
+		int nodeCount() const;
+
+		bool fingerprinting() const;
+		void setFingerprinting(bool fingerprinting);
+
+		bool includeUnhandled() const;
+		void setIncludeUnhandled(bool include_unhandled);
+
+		bool watching() const;
+		void setWatching(bool watching);
+
+		bool isEntryUnchanged(int entry, const QString &group) const;
+		bool isPageUnchanged(int page, const QString &group) const;
+		void markSaved(const QString &group);
+		void resetFingerprints();
+
+	public slots:
+		void invalidate();
+
+	private slots:
+		void changed();
+
+	signals:
+		void invalidated();
+
+	protected:
+		bool eventFilter(QObject *watched, QEvent *event) override;
+
+	private:
+		QPointer<QObject> m_root;
+		QVector<Entry> m_entries;
+		QVector<Page> m_pages;
+		Skipped m_skipped;
+		int m_node_count = 0;
+		QVector<QPointer<QObject>> m_watched;
+		QVector<QObject *> m_visited;
+		bool m_watching = true;
+		bool m_valid = false;
+		int m_revision = 0;
+
+		struct Fingerprint
+		{
+			int parent;
+			bool trackable;
+			quint64 changed;
+		};
+
+		bool m_fingerprinting = false;
+		bool m_include_unhandled = false;
+		int m_current_page = -1;
+		QVector<Fingerprint> m_page_fingerprints;
+		QVector<Fingerprint> m_entry_fingerprints;
+		QHash<QObject *, int> m_entry_indexes;
+		QHash<QObject *, int> m_member_indexes;
+		quint64 m_clock = 0;
+		quint64 m_saved_clock = 0;
+		bool m_saved = false;
+		QString m_saved_group;
+
+		void bindFingerprints();
+		void bindMembers(QObject *object, int entry, const QMetaMethod &slot);
+		void touch(int entry);
+
+		QVector<PlanTemplate::Node> m_nodes;
+		const PlanTemplate *m_template = nullptr;
+		int m_cursor = 0;
+
+		void clear();
+		bool build(const PlanTemplate *plan_template);
+		bool record(QObject *object, int flags);
+
+		void watch(QObject *object);
+		void release();
+
+		bool compileCascade(QObject *object);
+		bool compileChildren(QObject *object);
+	};
+
+} // namespace QDX
+
+#endif // QDX_SERIALIZATIONPLAN_H
@@ -0,0 +1,57 @@
+#include "SettingsStorage.h"
+
+#include <QSettings>
+#include <QFileInfo>
+
+QDX::SettingsStorage::SettingsStorage(QSettings &settings) : m_settings(settings)
+{
+
+}
+
+QDX::SettingsStorage::~SettingsStorage()
+{
+
+}
+
+QVariant QDX::SettingsStorage::read(const QString &path) const
+{
+	return m_settings.value(path);
+}
+
+void QDX::SettingsStorage::write(const QString &path, const QVariant &value)
+{
+	m_settings.setValue(path, value);
+}
+
+void QDX::SettingsStorage::erase(const QString &path)
+{
+	m_settings.remove(path);
+}
+
+QStringList QDX::SettingsStorage::keys(const QString &prefix) const
+{
+	if (prefix.isEmpty()) {
+		return m_settings.allKeys();
+	}
+	m_settings.beginGroup(prefix);
+	QStringList keys = m_settings.allKeys();
+	m_settings.endGroup();
+	return keys;
+}
+
+bool QDX::SettingsStorage::sync()
+{
+	m_settings.sync();
+	return m_settings.status() == QSettings::NoError;
+}
+
+qint64 QDX::SettingsStorage::storedSize() const
+{
+	QFileInfo info(m_settings.fileName());
+	return info.isFile() ? info.size() : -1;
+}
+
+QSettings *QDX::SettingsStorage::settings() const
+{
+	return &m_settings;
+}
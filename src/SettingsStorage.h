@@ -0,0 +1,29 @@
+#ifndef QDX_SETTINGSSTORAGE_H
+#define QDX_SETTINGSSTORAGE_H
+
+#include "Storage.h"
+
+namespace QDX {
+
+	class SettingsStorage : public Storage
+	{
+	public:
+		SettingsStorage(QSettings &settings);
+		virtual ~SettingsStorage();
+
+		QVariant read(const QString &path) const override;
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		QStringList keys(const QString &prefix = QString()) const override;
+
+		bool sync() override;
+		qint64 storedSize() const override;
+		QSettings *settings() const override;
+
+	private:
+		QSettings &m_settings;
+	};
+
+} // namespace QDX
+
+#endif // QDX_SETTINGSSTORAGE_H
@@ -0,0 +1,171 @@
+#include "SnapshotStorage.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDataStream>
+
+static const quint32 SNAPSHOT_MAGIC = 0x51445853;
+static const quint32 SNAPSHOT_VERSION = 1;
+
+QDX::SnapshotStorage::SnapshotStorage(const QString &file_name) : m_file_name(file_name)
+{
+
+}
+
+QDX::SnapshotStorage::~SnapshotStorage()
+{
+
+}
+
+QString QDX::SnapshotStorage::fileName() const
+{
+	return m_file_name;
+}
+
+void QDX::SnapshotStorage::setFileName(const QString &file_name)
+{
+	m_file_name = file_name;
+}
+
+bool QDX::SnapshotStorage::load()
+{
+	Values values;
+	if (readFile(m_file_name, values) == false) {
+		return false;
+	}
+	m_values = values;
+	return true;
+}
+
+bool QDX::SnapshotStorage::save() const
+{
+	return writeFile(m_file_name, m_values);
+}
+
+bool QDX::SnapshotStorage::sync()
+{
+	return this->save();
+}
+
+qint64 QDX::SnapshotStorage::storedSize() const
+{
+	QFileInfo info(m_file_name);
+	return info.isFile() ? info.size() : -1;
+}
+
+QByteArray QDX::SnapshotStorage::encode(const Values &values)
+{
+	QHash<QString, quint32> segment_indexes;
+	QStringList segments;
+	QVector<QVector<quint32>> paths;
+	paths.reserve(values.size());
+
+	for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+		QVector<quint32> path;
+		for (const QString &segment : it.key().split('/')) {
+			auto found = segment_indexes.constFind(segment);
+			if (found == segment_indexes.constEnd()) {
+				found = segment_indexes.insert(segment, segments.size());
+				segments.append(segment);
+			}
+			path.append(found.value());
+		}
+		paths.append(path);
+	}
+
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << SNAPSHOT_MAGIC << SNAPSHOT_VERSION;
+
+	stream << quint32(segments.size());
+	for (const QString &segment : qAsConst(segments)) {
+		stream << segment.toUtf8();
+	}
+
+	stream << quint32(values.size());
+	int index = 0;
+	for (auto it = values.constBegin(); it != values.constEnd(); ++it, ++index) {
+		const QVector<quint32> &path = paths.at(index);
+		stream << quint16(path.size());
+		for (quint32 segment : path) {
+			stream << segment;
+		}
+		stream << it.value();
+	}
+
+	return data;
+}
+
+bool QDX::SnapshotStorage::decode(const QByteArray &data, Values &values)
+{
+	QDataStream stream(data);
+	stream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 magic = 0, version = 0;
+	stream >> magic >> version;
+	if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+		return false;
+	}
+
+	quint32 segment_count = 0;
+	stream >> segment_count;
+	QStringList segments;
+	segments.reserve(int(qMin<quint32>(segment_count, 65536)));
+	QByteArray segment;
+	for (quint32 i = 0; i < segment_count && stream.status() == QDataStream::Ok; ++i) {
+		stream >> segment;
+		segments.append(QString::fromUtf8(segment));
+	}
+
+	quint32 record_count = 0;
+	stream >> record_count;
+	values.clear();
+	values.reserve(int(qMin<quint32>(record_count, 65536)));
+	QString path;
+	QVariant value;
+	for (quint32 i = 0; i < record_count && stream.status() == QDataStream::Ok; ++i) {
+		quint16 length = 0;
+		stream >> length;
+		path.clear();
+		for (quint16 j = 0; j < length; ++j) {
+			quint32 index = 0;
+			stream >> index;
+			if (index >= quint32(segments.size())) {
+				return false;
+			}
+			if (j > 0) {
+				path += '/';
+			}
+			path += segments.at(int(index));
+		}
+		stream >> value;
+		values.insert(path, value);
+	}
+
+	return stream.status() == QDataStream::Ok;
+}
+
+bool QDX::SnapshotStorage::readFile(const QString &file_name, Values &values)
+{
+	QFile file(file_name);
+	if (file.open(QIODevice::ReadOnly) == false) {
+		return false;
+	}
+	return decode(file.readAll(), values);
+}
+
+bool QDX::SnapshotStorage::writeFile(const QString &file_name, const Values &values)
+{
+	QSaveFile file(file_name);
+	if (file.open(QIODevice::WriteOnly) == false) {
+		return false;
+	}
+	const QByteArray data = encode(values);
+	if (file.write(data) != data.size()) {
+		file.cancelWriting();
+		return false;
+	}
+	return file.commit();
+}
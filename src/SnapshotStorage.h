@@ -0,0 +1,37 @@
+#ifndef QDX_SNAPSHOTSTORAGE_H
+#define QDX_SNAPSHOTSTORAGE_H
+
+#include <QByteArray>
+
+#include "MemoryStorage.h"
+
+namespace QDX {
+
+	class SnapshotStorage : public MemoryStorage
+	{
+	public:
+		SnapshotStorage(const QString &file_name = QString());
+		virtual ~SnapshotStorage();
+
+		QString fileName() const;
+		void setFileName(const QString &file_name);
+
+		bool load();
+		bool save() const;
+
+		bool sync() override;
+		qint64 storedSize() const override;
+
+		static QByteArray encode(const Values &values);
+		static bool decode(const QByteArray &data, Values &values);
+
+		static bool readFile(const QString &file_name, Values &values);
+		static bool writeFile(const QString &file_name, const Values &values);
+
+	private:
+		QString m_file_name;
+	};
+
+} // namespace QDX
+
+#endif // QDX_SNAPSHOTSTORAGE_H
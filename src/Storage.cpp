@@ -0,0 +1,222 @@
+#include "Storage.h"
+
+#include <QDataStream>
+
+QDX::Storage::Storage()
+{
+
+}
+
+QDX::Storage::~Storage()
+{
+
+}
+
+void QDX::Storage::beginGroup(const QString &prefix)
+{
+	m_group_sizes.append(m_group.size());
+	if (prefix.isEmpty()) {
+		return;
+	}
+	if (m_group.isEmpty() == false) {
+		m_group += '/';
+	}
+	m_group += prefix;
+}
+
+void QDX::Storage::endGroup()
+{
+	if (m_group_sizes.isEmpty()) {
+		return;
+	}
+	m_group.truncate(m_group_sizes.takeLast());
+}
+
+const QString &QDX::Storage::group() const
+{
+	return m_group;
+}
+
+QString QDX::Storage::path(const QString &key) const
+{
+	if (m_group.isEmpty()) {
+		return key;
+	}
+	if (key.isEmpty()) {
+		return m_group;
+	}
+	return m_group + '/' + key;
+}
+
+bool QDX::Storage::contains(const QString &key) const
+{
+	return this->read(this->path(key)).isValid();
+}
+
+QVariant QDX::Storage::value(const QString &key, const QVariant &default_value) const
+{
+	QVariant value = this->read(this->path(key));
+	return value.isValid() ? value : default_value;
+}
+
+void QDX::Storage::setValue(const QString &key, const QVariant &value)
+{
+	this->write(this->path(key), value);
+}
+
+void QDX::Storage::remove(const QString &key)
+{
+	this->erase(this->path(key));
+}
+
+QStringList QDX::Storage::allKeys() const
+{
+	return this->keys(m_group);
+}
+
+bool QDX::Storage::readBool(const QString &path, bool &value) const
+{
+	const QVariant stored = this->read(path);
+	if (stored.isValid() == false) {
+		return false;
+	}
+	value = stored.toBool();
+	return true;
+}
+
+bool QDX::Storage::readInt(const QString &path, int &value) const
+{
+	const QVariant stored = this->read(path);
+	if (stored.isValid() == false) {
+		return false;
+	}
+	value = stored.toInt();
+	return true;
+}
+
+bool QDX::Storage::readDouble(const QString &path, double &value) const
+{
+	const QVariant stored = this->read(path);
+	if (stored.isValid() == false) {
+		return false;
+	}
+	value = stored.toDouble();
+	return true;
+}
+
+bool QDX::Storage::readString(const QString &path, QString &value) const
+{
+	const QVariant stored = this->read(path);
+	if (stored.isValid() == false) {
+		return false;
+	}
+	value = stored.toString();
+	return true;
+}
+
+bool QDX::Storage::readBytes(const QString &path, QByteArray &value) const
+{
+	const QVariant stored = this->read(path);
+	if (stored.isValid() == false) {
+		return false;
+	}
+	value = stored.toByteArray();
+	return true;
+}
+
+void QDX::Storage::writeBool(const QString &path, bool value)
+{
+	this->write(path, value);
+}
+
+void QDX::Storage::writeInt(const QString &path, int value)
+{
+	this->write(path, value);
+}
+
+void QDX::Storage::writeDouble(const QString &path, double value)
+{
+	this->write(path, value);
+}
+
+void QDX::Storage::writeString(const QString &path, const QString &value)
+{
+	this->write(path, value);
+}
+
+void QDX::Storage::writeBytes(const QString &path, const QByteArray &value)
+{
+	this->write(path, value);
+}
+
+void QDX::Storage::eraseAll(const QStringList &paths)
+{
+	for (const QString &path : paths) {
+		this->erase(path);
+	}
+}
+
+bool QDX::Storage::sync()
+{
+	return true;
+}
+
+bool QDX::Storage::rewrite()
+{
+	return this->sync();
+}
+
+qint64 QDX::Storage::storedSize() const
+{
+	return -1;
+}
+
+static qint64 encodedSize(const QString &path, const QVariant &value)
+{
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream << value;
+	return path.toUtf8().size() + data.size();
+}
+
+qint64 QDX::Storage::compact(const KeyFilter &keep, Storage *archive, int *removed)
+{
+	qint64 size_before = this->storedSize();
+	qint64 estimated = 0;
+	QStringList doomed;
+	for (const QString &path : this->keys()) {
+		if (keep(path)) {
+			continue;
+		}
+		QVariant value = this->read(path);
+		if (archive) {
+			archive->write(path, value);
+		}
+		estimated += encodedSize(path, value);
+		doomed.append(path);
+	}
+	int count = doomed.size();
+	if (count > 0) {
+		this->eraseAll(doomed);
+	}
+	if (removed) {
+		*removed = count;
+	}
+	if (count == 0) {
+		return 0;
+	}
+	if (archive) {
+		archive->sync();
+	}
+	this->rewrite();
+	qint64 size_after = this->storedSize();
+	if (size_before >= 0 && size_after >= 0) {
+		return size_before - size_after;
+	}
+	return estimated;
+}
+
+QSettings *QDX::Storage::settings() const
+{
+	return nullptr;
+}
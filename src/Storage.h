@@ -0,0 +1,66 @@
+#ifndef QDX_STORAGE_H
+#define QDX_STORAGE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+
+class QSettings;
+
+namespace QDX {
+
+	class Storage
+	{
+	public:
+		Storage();
+		virtual ~Storage();
+
+		void beginGroup(const QString &prefix);
+		void endGroup();
+		const QString &group() const;
+		QString path(const QString &key) const;
+
+		bool contains(const QString &key) const;
+		QVariant value(const QString &key, const QVariant &default_value = QVariant()) const;
+		void setValue(const QString &key, const QVariant &value);
+		void remove(const QString &key);
+		QStringList allKeys() const;
+
+		virtual QVariant read(const QString &path) const = 0;
+		virtual void write(const QString &path, const QVariant &value) = 0;
+		virtual void erase(const QString &path) = 0;
+		virtual void eraseAll(const QStringList &paths);
+		virtual QStringList keys(const QString &prefix = QString()) const = 0;
+
+		virtual bool readBool(const QString &path, bool &value) const;
+		virtual bool readInt(const QString &path, int &value) const;
+		virtual bool readDouble(const QString &path, double &value) const;
+		virtual bool readString(const QString &path, QString &value) const;
+		virtual bool readBytes(const QString &path, QByteArray &value) const;
+
+		virtual void writeBool(const QString &path, bool value);
+		virtual void writeInt(const QString &path, int value);
+		virtual void writeDouble(const QString &path, double value);
+		virtual void writeString(const QString &path, const QString &value);
+		virtual void writeBytes(const QString &path, const QByteArray &value);
+
+		virtual bool sync();
+		virtual bool rewrite();
+		virtual qint64 storedSize() const;
+		virtual QSettings *settings() const;
+
+		typedef std::function<bool (const QString &path)> KeyFilter;
+
+		virtual qint64 compact(const KeyFilter &keep, Storage *archive = nullptr, int *removed = nullptr);
+
+	private:
+		QString m_group;
+		QVector<int> m_group_sizes;
+	};
+
+} // namespace QDX
+
+#endif // QDX_STORAGE_H
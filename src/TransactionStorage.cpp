@@ -0,0 +1,120 @@
+#include "TransactionStorage.h"
+
+QDX::TransactionStorage::TransactionStorage(Storage &base) : m_base(base)
+{
+
+}
+
+QDX::TransactionStorage::~TransactionStorage()
+{
+
+}
+
+QDX::Storage &QDX::TransactionStorage::base() const
+{
+	return m_base;
+}
+
+bool QDX::TransactionStorage::isEmpty() const
+{
+	return m_changes.isEmpty();
+}
+
+int QDX::TransactionStorage::count() const
+{
+	return m_changes.size();
+}
+
+bool QDX::TransactionStorage::commit()
+{
+	if (m_changes.isEmpty()) {
+		return true;
+	}
+	for (const Change &change : qAsConst(m_changes)) {
+		if (change.erased) {
+			m_base.erase(change.path);
+		} else {
+			m_base.write(change.path, change.value);
+		}
+	}
+	this->rollback();
+	return m_base.sync();
+}
+
+void QDX::TransactionStorage::rollback()
+{
+	m_changes.clear();
+	m_writes.clear();
+	m_erased.clear();
+}
+
+bool QDX::TransactionStorage::isErased(const QString &path) const
+{
+	if (m_erased.isEmpty()) {
+		return false;
+	}
+	if (m_erased.contains(QString()) || m_erased.contains(path)) {
+		return true;
+	}
+	for (int i = path.indexOf('/'); i >= 0; i = path.indexOf('/', i + 1)) {
+		if (m_erased.contains(path.left(i))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+QVariant QDX::TransactionStorage::read(const QString &path) const
+{
+	auto found = m_writes.constFind(path);
+	if (found != m_writes.constEnd()) {
+		return m_changes.at(found.value()).value;
+	}
+	if (this->isErased(path)) {
+		return QVariant();
+	}
+	return m_base.read(path);
+}
+
+void QDX::TransactionStorage::write(const QString &path, const QVariant &value)
+{
+	auto found = m_writes.constFind(path);
+	if (found != m_writes.constEnd()) {
+		m_changes[found.value()].value = value;
+		return;
+	}
+	m_writes.insert(path, m_changes.size());
+	m_changes.append({ path, value, false });
+}
+
+void QDX::TransactionStorage::erase(const QString &path)
+{
+	const QString prefix = path + '/';
+	for (auto it = m_writes.begin(); it != m_writes.end(); ) {
+		if (path.isEmpty() || it.key() == path || it.key().startsWith(prefix)) {
+			it = m_writes.erase(it);
+		} else {
+			++it;
+		}
+	}
+	m_erased.insert(path);
+	m_changes.append({ path, QVariant(), true });
+}
+
+QStringList QDX::TransactionStorage::keys(const QString &prefix) const
+{
+	const QString group = prefix.isEmpty() ? QString() : prefix + '/';
+	QStringList keys;
+	for (const QString &key : m_base.keys(prefix)) {
+		const QString path = group + key;
+		if (m_writes.contains(path) == false && this->isErased(path) == false) {
+			keys.append(key);
+		}
+	}
+	for (auto it = m_writes.constBegin(); it != m_writes.constEnd(); ++it) {
+		if (group.isEmpty() || it.key().startsWith(group)) {
+			keys.append(it.key().mid(group.size()));
+		}
+	}
+	return keys;
+}
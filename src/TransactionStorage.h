@@ -0,0 +1,49 @@
+#ifndef QDX_TRANSACTIONSTORAGE_H
+#define QDX_TRANSACTIONSTORAGE_H
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include "Storage.h"
+
+namespace QDX {
+
+	class TransactionStorage : public Storage
+	{
+	public:
+		TransactionStorage(Storage &base);
+		virtual ~TransactionStorage();
+
+		Storage &base() const;
+
+		bool isEmpty() const;
+		int count() const;
+
+		bool commit();
+		void rollback();
+
+		QVariant read(const QString &path) const override;
+		void write(const QString &path, const QVariant &value) override;
+		void erase(const QString &path) override;
+		QStringList keys(const QString &prefix = QString()) const override;
+
+	private:
+		struct Change
+		{
+			QString path;
+			QVariant value;
+			bool erased;
+		};
+
+		Storage &m_base;
+		QVector<Change> m_changes;
+		QHash<QString, int> m_writes;
+		QSet<QString> m_erased;
+
+		bool isErased(const QString &path) const;
+	};
+
+} // namespace QDX
+
+#endif // QDX_TRANSACTIONSTORAGE_H
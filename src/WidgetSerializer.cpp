@@ -11,43 +11,152 @@
 #include <QSplitter>
 #include <QComboBox>
 #include <QMenu>
+#include <QActionGroup>
 #include <QStackedWidget>
+#include <QSignalBlocker>
+#include <QTimer>
+#include <QEvent>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
 
 #include "SerializableWidget.h"
+#include "SettingsStorage.h"
+#include "TransactionStorage.h"
+#include "ProfileStorage.h"
+#include "SerializationPlan.h"
+#include "CascadeTask.h"
 
-QDX::WidgetSerializer::WidgetSerializer(QSettings &settings) : m_settings(settings)
+QDX::WidgetSerializer::WidgetSerializer(QSettings &settings) : m_storage(new SettingsStorage(settings))
+{
+	m_owned_storage = m_storage;
+}
+
+QDX::WidgetSerializer::WidgetSerializer(Storage &storage) : m_storage(&storage)
 {
 
 }
 
 QDX::WidgetSerializer::~WidgetSerializer()
 {
+	const QList<CascadeTask *> tasks = m_tasks;
+	for (CascadeTask *task : tasks) {
+		task->cancel();
+	}
+	m_tasks.clear();
+	const QHash<QObject *, LazyRestore *> restores = m_lazy_restores;
+	m_lazy_restores.clear();
+	qDeleteAll(restores);
+	qDeleteAll(m_plans);
+	this->rollback();
+	delete m_profiles;
+	delete m_owned_storage;
+}
 
+QDX::Storage &QDX::WidgetSerializer::storage() const
+{
+	return *m_storage;
 }
 
 QSettings &QDX::WidgetSerializer::settings() const
 {
-	return m_settings;
+	QSettings *settings = this->backingSettings();
+	Q_ASSERT_X(settings, "WidgetSerializer::settings", "storage is not backed by QSettings");
+	return *settings;
+}
+
+QSettings *QDX::WidgetSerializer::backingSettings() const
+{
+	return this->backingStorage().settings();
+}
+
+QDX::Storage &QDX::WidgetSerializer::backingStorage() const
+{
+	if (m_profiles) {
+		return m_profiles->base();
+	}
+	if (m_transaction) {
+		return m_transaction->base();
+	}
+	return *m_storage;
+}
+
+bool QDX::WidgetSerializer::beginTransaction() const
+{
+	if (m_transaction) {
+		return false;
+	}
+	m_transaction = new TransactionStorage(*m_storage);
+	if (m_storage->group().isEmpty() == false) {
+		m_transaction->beginGroup(m_storage->group());
+	}
+	m_storage = m_transaction;
+	return true;
+}
+
+bool QDX::WidgetSerializer::commit() const
+{
+	if (m_transaction == nullptr) {
+		return false;
+	}
+	m_storage = &m_transaction->base();
+	bool result = m_transaction->commit();
+	delete m_transaction;
+	m_transaction = nullptr;
+	return result;
+}
+
+void QDX::WidgetSerializer::rollback() const
+{
+	if (m_transaction == nullptr) {
+		return;
+	}
+	m_storage = &m_transaction->base();
+	delete m_transaction;
+	m_transaction = nullptr;
+	this->resetTracking();
+}
+
+void QDX::WidgetSerializer::resetTracking() const
+{
+	m_tracked_values.clear();
+	m_tracked_histories.clear();
+	m_blobs.clear();
+	for (SerializationPlan *plan : qAsConst(m_plans)) {
+		plan->resetFingerprints();
+	}
+}
+
+bool QDX::WidgetSerializer::inTransaction() const
+{
+	return m_transaction != nullptr;
 }
 
 #define validate(object, name) if (object == nullptr) { return false; } \
 	QString key = name; \
 	if (key.isEmpty()) { key = object->objectName(); if (key.isEmpty()) { return false; } } \
 
-#define validate_contains(object, name) validate(object, name) \
-	if (m_settings.contains(key) == false) { return false; }
+#define validate_value(object, name) validate(object, name) \
+	QVariant value; \
+	if (this->read(key, value) == false) { return false; }
+
+#define validate_typed(object, name, type) validate(object, name) \
+	type value; \
+	if (this->readTyped(key, value) == false) { return false; }
 
 bool QDX::WidgetSerializer::save(QCheckBox *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->isChecked());
+	this->writeTyped(key, widget->isChecked());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QCheckBox *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->setChecked(m_settings.value(key).toBool());
+	validate_typed(widget, name, bool);
+	if (widget->isChecked() != value) {
+		widget->setChecked(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
@@ -57,107 +166,151 @@ bool QDX::WidgetSerializer::save(QPushButton *widget, const QString &name) const
 	if (widget->isCheckable() == false) {
 		return false;
 	}
-	m_settings.setValue(key, widget->isChecked());
+	this->writeTyped(key, widget->isChecked());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QPushButton *widget, const QString &name) const
 {
-	validate_contains(widget, name);
+	validate_typed(widget, name, bool);
 	if (widget->isCheckable() == false) {
 		return false;
 	}
-	widget->setChecked(m_settings.value(key).toBool());
+	if (widget->isChecked() != value) {
+		widget->setChecked(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
 bool QDX::WidgetSerializer::save(QRadioButton *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->isChecked());
+	this->writeTyped(key, widget->isChecked());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QRadioButton *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->setChecked(m_settings.value(key).toBool());
+	validate_typed(widget, name, bool);
+	if (widget->isChecked() != value) {
+		widget->setChecked(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
 bool QDX::WidgetSerializer::save(QSpinBox *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->value());
+	this->writeTyped(key, widget->value());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QSpinBox *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->setValue(m_settings.value(key).toInt());
+	validate_typed(widget, name, int);
+	if (widget->value() != value) {
+		widget->setValue(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
 bool QDX::WidgetSerializer::save(QDoubleSpinBox *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->value());
+	this->writeTyped(key, widget->value());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QDoubleSpinBox *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->setValue(m_settings.value(key).toDouble());
+	validate_typed(widget, name, double);
+	if (widget->value() != value) {
+		widget->setValue(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
 bool QDX::WidgetSerializer::save(QLineEdit *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->text());
+	this->writeTyped(key, widget->text());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QLineEdit *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->setText(m_settings.value(key).toString());
+	validate_typed(widget, name, QString);
+	if (widget->text() != value) {
+		widget->setText(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
 bool QDX::WidgetSerializer::save(QTabWidget *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->currentIndex());
+	this->writeTyped(key, widget->currentIndex());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QTabWidget *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->setCurrentIndex(m_settings.value(key).toInt());
+	validate_typed(widget, name, int);
+	if (widget->currentIndex() != value) {
+		widget->setCurrentIndex(value);
+		this->restored(widget);
+	}
 	return true;
 }
 
 bool QDX::WidgetSerializer::save(QSplitter *widget, const QString &name) const
 {
 	validate(widget, name);
-	m_settings.setValue(key, widget->saveState());
+	this->writeBlob(key, widget->saveState());
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(QSplitter *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->restoreState(m_settings.value(key).toByteArray());
+	validate(widget, name);
+	QByteArray state;
+	if (this->readBlob(key, state) == false) {
+		return false;
+	}
+	if (widget->saveState() != state) {
+		widget->restoreState(state);
+		this->restored(widget);
+	}
 	return true;
 }
 
-static QString &purifyActionName(QString &name)
+static QString purifyActionName(const QString &name)
+{
+	static const QLatin1String prefix("action");
+	if (name.startsWith(prefix, Qt::CaseInsensitive)) {
+		return name.mid(prefix.size());
+	}
+	return name;
+}
+
+static void setActionChecked(QAction *action, bool checked)
 {
-	return name.remove(QRegularExpression("^action", QRegularExpression::CaseInsensitiveOption));
+	action->setChecked(checked);
+	QActionGroup *group = action->actionGroup();
+	if (checked == false || action->signalsBlocked() == false || group == nullptr || group->isExclusive() == false) {
+		return;
+	}
+	foreach (QAction *other, group->actions()) {
+		if (other != action && other->isChecked()) {
+			QSignalBlocker blocker(other);
+			other->setChecked(false);
+		}
+	}
 }
 
 bool QDX::WidgetSerializer::save(QAction *action, const QString &name) const
@@ -166,9 +319,7 @@ bool QDX::WidgetSerializer::save(QAction *action, const QString &name) const
 		return false;
 	}
 	validate(action, name);
-	QString clean_key = key;
-	purifyActionName(clean_key);
-	m_settings.setValue(clean_key, action->isChecked());
+	this->writeTyped(this->actionKey(key), action->isChecked());
 	return true;
 }
 
@@ -178,10 +329,12 @@ bool QDX::WidgetSerializer::load(QAction *action, const QString &name) const
 		return false;
 	}
 	validate(action, name);
-	QString clean_key = key;
-	purifyActionName(clean_key);
-	if (m_settings.contains(clean_key)) {
-		action->setChecked(m_settings.value(clean_key).toBool());
+	bool value;
+	if (this->readTyped(this->actionKey(key), value)) {
+		if (action->isChecked() != value) {
+			setActionChecked(action, value);
+			this->restored(action);
+		}
 		return true;
 	}
 	return false;
@@ -190,19 +343,28 @@ bool QDX::WidgetSerializer::load(QAction *action, const QString &name) const
 bool QDX::WidgetSerializer::save(QActionGroup *group, const QString &name) const
 {
 	validate(group, name);
-	purifyActionName(key);
-	QString child_name;
+	const QString group_key = this->actionKey(key);
+	auto index = m_action_indexes.constFind(group);
+	if (group->isExclusive() && index != m_action_indexes.constEnd() && index.value().group == group) {
+		QAction *action = index.value().checked;
+		if (action && action->isChecked() && action->actionGroup() == group) {
+			const QString &child_name = this->actionKey(action->objectName());
+			if (child_name.isEmpty() == false) {
+				this->writeTyped(group_key, child_name);
+				return true;
+			}
+		}
+	}
 	foreach (QAction *action, group->actions()) {
 		if (action->isCheckable() == false) {
 			continue;
 		}
-		child_name = action->objectName();
-		purifyActionName(child_name);
+		const QString &child_name = this->actionKey(action->objectName());
 		if (child_name.isEmpty()) {
 			continue;
 		}
 		if (action->isChecked()) {
-			m_settings.setValue(key, child_name);
+			this->writeTyped(group_key, child_name);
 			return true;
 		}
 	}
@@ -212,36 +374,202 @@ bool QDX::WidgetSerializer::save(QActionGroup *group, const QString &name) const
 bool QDX::WidgetSerializer::load(QActionGroup *group, const QString &name) const
 {
 	validate(group, name);
-	purifyActionName(key);
-	if (m_settings.contains(key) == false) {
+	QString stored;
+	if (this->readTyped(this->actionKey(key), stored) == false) {
+		return false;
+	}
+	QAction *action = this->groupAction(group, stored);
+	if (action == nullptr) {
 		return false;
 	}
-	QString value = m_settings.value(key).toString();
+	if (action->isChecked() == false) {
+		QSignalBlocker blocker(m_suppress_signals ? action : nullptr);
+		setActionChecked(action, true);
+		if (m_suppress_signals == false) {
+			action->trigger();
+		}
+		this->restored(group);
+	}
+	m_action_indexes[group].checked = action;
+	return true;
+}
+
+QAction *QDX::WidgetSerializer::groupAction(QActionGroup *group, const QString &name) const
+{
+	if (name.isEmpty()) {
+		return nullptr;
+	}
+	auto it = m_action_indexes.find(group);
+	if (it != m_action_indexes.end() && it.value().group == group) {
+		QAction *action = it.value().actions.value(name);
+		if (action && action->actionGroup() == group && action->isCheckable() && this->actionKey(action->objectName()) == name) {
+			return action;
+		}
+	}
+
+	for (auto stale = m_action_indexes.begin(); stale != m_action_indexes.end(); ) {
+		if (stale.value().group == nullptr) {
+			stale = m_action_indexes.erase(stale);
+		} else {
+			++stale;
+		}
+	}
 
-	QString child_name;
+	ActionIndex &index = m_action_indexes[group];
+	index.group = group;
+	index.actions.clear();
 	foreach (QAction *action, group->actions()) {
 		if (action->isCheckable() == false) {
 			continue;
 		}
-		child_name = action->objectName();
-		purifyActionName(child_name);
-		if (child_name.isEmpty()) {
+		const QString &child_name = this->actionKey(action->objectName());
+		if (child_name.isEmpty() == false && index.actions.contains(child_name) == false) {
+			index.actions.insert(child_name, action);
+		}
+	}
+	return index.actions.value(name);
+}
+
+static QStringList comboItems(const QComboBox *widget)
+{
+	QStringList items;
+	int count = widget->count();
+	items.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		items.append(widget->itemText(i));
+	}
+	return items;
+}
+
+static bool reconcileItems(QComboBox *widget, const QStringList &items)
+{
+	bool changed = false;
+	int count = items.size();
+	for (int i = 0; i < count; ++i) {
+		const QString &text = items.at(i);
+		int current_count = widget->count();
+		if (i < current_count && widget->itemText(i) == text) {
 			continue;
 		}
-		if (child_name == value) {
-			action->setChecked(true);
-			action->trigger();
+		int found = -1;
+		for (int j = i + 1; j < current_count; ++j) {
+			if (widget->itemText(j) == text) {
+				found = j;
+				break;
+			}
+		}
+		if (found >= 0) {
+			widget->removeItem(found);
+		}
+		widget->insertItem(i, text);
+		changed = true;
+	}
+	while (widget->count() > count) {
+		widget->removeItem(widget->count() - 1);
+		changed = true;
+	}
+	return changed;
+}
+
+static const char HISTORY_MAGIC[] = "QDXH";
+static const int HISTORY_MAGIC_SIZE = 4;
+static const quint8 HISTORY_VERSION = 1;
+static const quint8 HISTORY_COMPRESSED = 0x01;
+static const int HISTORY_COMPRESSION_THRESHOLD = 256;
+
+static void appendLength(QByteArray &data, quint32 length)
+{
+	while (length >= 0x80) {
+		data.append(char((length & 0x7F) | 0x80));
+		length >>= 7;
+	}
+	data.append(char(length));
+}
+
+static bool readLength(const QByteArray &data, int &position, quint32 &length)
+{
+	length = 0;
+	for (int shift = 0; shift < 35; shift += 7) {
+		if (position >= data.size()) {
+			return false;
+		}
+		quint8 byte = quint8(data.at(position++));
+		length |= quint32(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
 			return true;
 		}
 	}
 	return false;
 }
 
+QByteArray QDX::WidgetSerializer::encodeHistory(const QStringList &items, bool compress)
+{
+	QByteArray payload;
+	appendLength(payload, quint32(items.size()));
+	for (const QString &item : items) {
+		const QByteArray utf8 = item.toUtf8();
+		appendLength(payload, quint32(utf8.size()));
+		payload.append(utf8);
+	}
+
+	quint8 flags = 0;
+	if (compress && payload.size() > HISTORY_COMPRESSION_THRESHOLD) {
+		QByteArray compressed = qCompress(payload);
+		if (compressed.size() < payload.size()) {
+			payload = compressed;
+			flags |= HISTORY_COMPRESSED;
+		}
+	}
+
+	QByteArray data;
+	data.reserve(HISTORY_MAGIC_SIZE + 2 + payload.size());
+	data.append(HISTORY_MAGIC, HISTORY_MAGIC_SIZE);
+	data.append(char(HISTORY_VERSION));
+	data.append(char(flags));
+	data.append(payload);
+	return data;
+}
+
+bool QDX::WidgetSerializer::decodeHistory(const QVariant &value, QStringList &items)
+{
+	items.clear();
+	if (value.type() != QVariant::ByteArray) {
+		items = value.toStringList();
+		return true;
+	}
+	const QByteArray data = value.toByteArray();
+	if (data.size() < HISTORY_MAGIC_SIZE + 2 || data.startsWith(HISTORY_MAGIC) == false || quint8(data.at(HISTORY_MAGIC_SIZE)) != HISTORY_VERSION) {
+		return false;
+	}
+	quint8 flags = quint8(data.at(HISTORY_MAGIC_SIZE + 1));
+	QByteArray payload = data.mid(HISTORY_MAGIC_SIZE + 2);
+	if (flags & HISTORY_COMPRESSED) {
+		payload = qUncompress(payload);
+	}
+
+	int position = 0;
+	quint32 count = 0;
+	if (readLength(payload, position, count) == false) {
+		return false;
+	}
+	items.reserve(int(qMin<quint32>(count, quint32(payload.size()))));
+	for (quint32 i = 0; i < count; ++i) {
+		quint32 length = 0;
+		if (readLength(payload, position, length) == false || length > quint32(payload.size() - position)) {
+			items.clear();
+			return false;
+		}
+		items.append(QString::fromUtf8(payload.constData() + position, int(length)));
+		position += int(length);
+	}
+	return true;
+}
+
 bool QDX::WidgetSerializer::save(QComboBox *widget, const QString &name) const
 {
 	validate(widget, name);
 	if (widget->isEditable()) {
-		m_settings.setValue(key, widget->currentText());
+		this->writeTyped(key, widget->currentText());
 
 		int count = widget->count();
 		QStringList items;
@@ -249,6 +577,7 @@ bool QDX::WidgetSerializer::save(QComboBox *widget, const QString &name) const
 		int history = historyLimit(widget);
 		if (history > 0) {
 			if (this->omitHistory()) {
+				this->collect(this->itemsKey(key));
 				return true;
 			}
 
@@ -266,15 +595,26 @@ bool QDX::WidgetSerializer::save(QComboBox *widget, const QString &name) const
 				}
 			}
 		} else {
-			items.reserve(count);
-			for (int i = 0; i < count; ++i) {
-				items.append(widget->itemText(i));
-			}
+			items = comboItems(widget);
 		}
 
-		m_settings.setValue(key + ".items", items);
+		const QString &items_key = this->itemsKey(key);
+		if (m_compact_history) {
+			if (m_track_changes) {
+				const QString tracked_key = this->trackedKey(items_key);
+				auto it = m_tracked_histories.find(tracked_key);
+				if (it != m_tracked_histories.end() && it.value() == items) {
+					this->collect(items_key);
+					return true;
+				}
+				m_tracked_histories.insert(tracked_key, items);
+			}
+			this->write(items_key, encodeHistory(items, m_history_compression));
+		} else {
+			this->write(items_key, items);
+		}
 	} else {
-		m_settings.setValue(key, widget->currentIndex());
+		this->writeTyped(key, widget->currentIndex());
 	}
 	return true;
 }
@@ -283,25 +623,40 @@ bool QDX::WidgetSerializer::load(QComboBox *widget, const QString &name) const
 {
 	validate(widget, name);
 	if (widget->isEditable()) {
-		const QString items_key = key + ".items";
-		if (m_settings.contains(items_key)) {
+		bool changed = false;
+		QVariant value;
+		if (this->read(this->itemsKey(key), value)) {
 			int history = historyLimit(widget);
-			if (history > 0) {
-				if (this->omitHistory() == false) {
-					widget->clear();
-					widget->addItems(m_settings.value(items_key).toStringList().mid(0, history));
+			if (history <= 0 || this->omitHistory() == false) {
+				QStringList items;
+				if (decodeHistory(value, items)) {
+					if (history > 0 && items.size() > history) {
+						items = items.mid(0, history);
+					}
+					if (m_track_changes && m_compact_history) {
+						m_tracked_histories.insert(this->trackedKey(this->itemsKey(key)), items);
+					}
+					if (reconcileItems(widget, items)) {
+						changed = true;
+					}
 				}
-			} else {
-				widget->clear();
-				widget->addItems(m_settings.value(items_key).toStringList());
 			}
 		}
-		if (m_settings.contains(key)) {
-			widget->setCurrentText(m_settings.value(key).toString());
+		QString text;
+		if (this->readTyped(key, text)) {
+			if (changed || widget->currentText() != text) {
+				widget->setCurrentText(text);
+				changed = true;
+			}
+		}
+		if (changed) {
+			this->restored(widget);
 		}
 	} else {
-		if (m_settings.contains(key)) {
-			widget->setCurrentIndex(m_settings.value(key).toInt());
+		int index;
+		if (this->readTyped(key, index) && widget->currentIndex() != index) {
+			widget->setCurrentIndex(index);
+			this->restored(widget);
 		}
 	}
 	return true;
@@ -310,243 +665,1203 @@ bool QDX::WidgetSerializer::load(QComboBox *widget, const QString &name) const
 bool QDX::WidgetSerializer::save(SerializableWidget *widget, const QString &name) const
 {
 	validate(widget, name);
-	widget->save(key, m_settings);
+	this->collect(key, true);
+	widget->save(key, *m_storage);
 	return true;
 }
 
 bool QDX::WidgetSerializer::load(SerializableWidget *widget, const QString &name) const
 {
-	validate_contains(widget, name);
-	widget->load(key, m_settings);
+	validate_value(widget, name);
+	widget->load(key, *m_storage);
+	this->restored(widget);
 	return true;
 }
 
-#define saveCast(type, object) if (type *casted_object = qobject_cast<type *>(object)) { if (casted) { *casted = true; } return this->save(casted_object, name); }
-#define loadCast(type, object) if (type *casted_object = qobject_cast<type *>(object)) { if (casted) { *casted = true; } return this->load(casted_object, name); }
-
 bool QDX::WidgetSerializer::save(QWidget *widget, const QString &name, bool *casted) const
 {
-	saveCast(SerializableWidget, widget);
-	saveCast(QCheckBox, widget);
-	saveCast(QPushButton, widget);
-	saveCast(QRadioButton, widget);
-	saveCast(QSpinBox, widget);
-	saveCast(QDoubleSpinBox, widget);
-	saveCast(QLineEdit, widget);
-	saveCast(QTabWidget, widget);
-	saveCast(QSplitter, widget);
-	saveCast(QComboBox, widget);
-	if (casted) {
-		*casted = false;
-	}
-	return false;
+	return this->performObject(widget, name, casted, false);
 }
 
 bool QDX::WidgetSerializer::load(QWidget *widget, const QString &name, bool *casted) const
 {
-	loadCast(SerializableWidget, widget);
-	loadCast(QCheckBox, widget);
-	loadCast(QPushButton, widget);
-	loadCast(QRadioButton, widget);
-	loadCast(QSpinBox, widget);
-	loadCast(QDoubleSpinBox, widget);
-	loadCast(QLineEdit, widget);
-	loadCast(QTabWidget, widget);
-	loadCast(QSplitter, widget);
-	loadCast(QComboBox, widget);
-	if (casted) {
-		*casted = false;
-	}
-	return false;
+	return this->performObject(widget, name, casted, true);
 }
 
 bool QDX::WidgetSerializer::save(QObject *object, const QString &name, bool *casted) const
 {
-	saveCast(QActionGroup, object);
-	saveCast(QAction, object);
-	if (object->isWidgetType()) {
-		return this->save(qobject_cast<QWidget *>(object), name, casted);
-	}
-	if (casted) {
-		*casted = false;
+	if (object && object->isWidgetType()) {
+		return this->save(static_cast<QWidget *>(object), name, casted);
 	}
-	return false;
+	return this->performObject(object, name, casted, false);
 }
 
 bool QDX::WidgetSerializer::load(QObject *object, const QString &name, bool *casted) const
 {
-	loadCast(QActionGroup, object);
-	loadCast(QAction, object);
-	if (object->isWidgetType()) {
-		return this->load(qobject_cast<QWidget *>(object), name, casted);
+	if (object && object->isWidgetType()) {
+		return this->load(static_cast<QWidget *>(object), name, casted);
 	}
+	return this->performObject(object, name, casted, true);
+}
+
+bool QDX::WidgetSerializer::performObject(QObject *object, const QString &name, bool *casted, bool is_load) const
+{
+	QSharedPointer<const TypeHandler> handler = object ? findHandler(object->metaObject()) : nullptr;
 	if (casted) {
-		*casted = false;
+		*casted = handler != nullptr;
 	}
-	return false;
+	return this->perform(handler.data(), object, name, is_load);
 }
 
-bool QDX::WidgetSerializer::saveCascade(QObject *object, const QString &group_name) const
-{
-	return this->performCascade(object, false, group_name);
+namespace {
+
+	struct HandlerRegistry
+	{
+		QHash<const QMetaObject *, QSharedPointer<const QDX::WidgetSerializer::TypeHandler>> registered;
+		QHash<const QMetaObject *, QSharedPointer<const QDX::WidgetSerializer::TypeHandler>> resolved;
+		int revision = 0;
+
+		HandlerRegistry();
+	};
+
+	HandlerRegistry &registry()
+	{
+		static HandlerRegistry instance;
+		return instance;
+	}
+
+	QSharedPointer<const QDX::WidgetSerializer::TypeHandler> createHandler(const QMetaObject &meta_object, const QDX::WidgetSerializer::Handler &save, const QDX::WidgetSerializer::Handler &load, const QList<QByteArray> &notifiers)
+	{
+		QDX::WidgetSerializer::TypeHandler *handler = new QDX::WidgetSerializer::TypeHandler { save, load, { }, &meta_object };
+		for (const QByteArray &notifier : notifiers) {
+			int index = meta_object.indexOfSignal(QMetaObject::normalizedSignature(notifier.constData()).constData());
+			if (index >= 0) {
+				handler->notifiers.append(meta_object.method(index));
+			}
+		}
+		return QSharedPointer<const QDX::WidgetSerializer::TypeHandler>(handler);
+	}
+
 }
 
-bool QDX::WidgetSerializer::loadCascade(QObject *object, const QString &group_name) const
+#define defaultHandler(type, ...) registered.insert(&type::staticMetaObject, createHandler(type::staticMetaObject, \
+	[](const QDX::WidgetSerializer &serializer, QObject *object, const QString &name) { return serializer.save(static_cast<type *>(object), name); }, \
+	[](const QDX::WidgetSerializer &serializer, QObject *object, const QString &name) { return serializer.load(static_cast<type *>(object), name); }, \
+	{ __VA_ARGS__ }));
+
+HandlerRegistry::HandlerRegistry()
 {
-	return this->performCascade(object, true, group_name);
+	defaultHandler(QDX::SerializableWidget, );
+	defaultHandler(QCheckBox, "toggled(bool)");
+	defaultHandler(QPushButton, "toggled(bool)");
+	defaultHandler(QRadioButton, "toggled(bool)");
+	defaultHandler(QSpinBox, "valueChanged(int)");
+	defaultHandler(QDoubleSpinBox, "valueChanged(double)");
+	defaultHandler(QLineEdit, "textChanged(QString)");
+	defaultHandler(QTabWidget, "currentChanged(int)");
+	defaultHandler(QSplitter, "splitterMoved(int,int)");
+	defaultHandler(QComboBox, "currentIndexChanged(int)", "editTextChanged(QString)");
+	defaultHandler(QActionGroup, "triggered(QAction*)");
+	defaultHandler(QAction, "toggled(bool)");
 }
 
-bool QDX::WidgetSerializer::saveChildren(QObject *object, const QString &group_name) const
+void QDX::WidgetSerializer::registerHandler(const QMetaObject &meta_object, const Handler &save, const Handler &load, const QList<QByteArray> &notifiers)
 {
-	return this->performChildren(object, false, group_name);
+	HandlerRegistry &registry = ::registry();
+	registry.registered.insert(&meta_object, createHandler(meta_object, save, load, notifiers));
+	registry.resolved.clear();
+	++registry.revision;
 }
 
-bool QDX::WidgetSerializer::loadChildren(QObject *object, const QString &group_name) const
+void QDX::WidgetSerializer::unregisterHandler(const QMetaObject &meta_object)
 {
-	return this->performChildren(object, true, group_name);
+	HandlerRegistry &registry = ::registry();
+	if (registry.registered.remove(&meta_object)) {
+		registry.resolved.clear();
+		++registry.revision;
+	}
 }
 
-bool QDX::WidgetSerializer::performCascade(QObject *object, bool is_load, const QString &group_name) const
+QSharedPointer<const QDX::WidgetSerializer::TypeHandler> QDX::WidgetSerializer::findHandler(const QMetaObject *meta_object)
 {
-	if (object == nullptr) {
-		return 0;
+	HandlerRegistry &registry = ::registry();
+	auto it = registry.resolved.constFind(meta_object);
+	if (it != registry.resolved.constEnd()) {
+		return it.value();
 	}
+	QSharedPointer<const TypeHandler> handler;
+	for (const QMetaObject *meta = meta_object; meta && handler == nullptr; meta = meta->superClass()) {
+		handler = registry.registered.value(meta);
+	}
+	registry.resolved.insert(meta_object, handler);
+	return handler;
+}
 
-	bool group_opened = false;
-
-	QWidget *widget = qobject_cast<QWidget *>(object);
+int QDX::WidgetSerializer::handlersRevision()
+{
+	return registry().revision;
+}
 
-	if (group_name.isEmpty() == false || (widget && widget->isWindow())) {
-		m_settings.beginGroup(group_name.isEmpty() ? object->objectName() : group_name);
-		group_opened = true;
-	}
+static const int MAX_TEMPLATES = 8;
+
+static const char BLOB_GROUP_NAME[] = "__blobs";
+static const char BLOB_GROUP[] = "__blobs/";
+static const char BLOB_REFERENCES_NAME[] = "__blobrefs";
+static const char BLOB_REFERENCES[] = "__blobrefs/";
+static const char BLOB_REFERENCE[] = "blob:";
+static const int BLOB_REFERENCE_SIZE = 5;
+static const char BLOB_MAGIC[] = "QDXB";
+static const int BLOB_MAGIC_SIZE = 4;
+static const quint8 BLOB_VERSION = 1;
+static const quint8 BLOB_COMPRESSED = 0x01;
+static const int BLOB_COMPRESSION_THRESHOLD = 64;
+
+static bool isBlobPath(const QString &path)
+{
+	return path.startsWith(QLatin1String(BLOB_GROUP)) || path.startsWith(QLatin1String(BLOB_REFERENCES));
+}
 
-	if (this->omitWindow() == false) {
-		if (is_load) {
-			this->loadWindow(widget);
-		} else {
-			this->saveWindow(widget);
+QByteArray QDX::WidgetSerializer::encodeBlob(const QByteArray &data, bool compress)
+{
+	QByteArray payload = data;
+	quint8 flags = 0;
+	if (compress && payload.size() > BLOB_COMPRESSION_THRESHOLD) {
+		QByteArray compressed = qCompress(payload);
+		if (compressed.size() < payload.size()) {
+			payload = compressed;
+			flags |= BLOB_COMPRESSED;
 		}
 	}
 
-	this->performCascade(object, is_load);
+	QByteArray blob;
+	blob.reserve(BLOB_MAGIC_SIZE + 2 + payload.size());
+	blob.append(BLOB_MAGIC, BLOB_MAGIC_SIZE);
+	blob.append(char(BLOB_VERSION));
+	blob.append(char(flags));
+	blob.append(payload);
+	return blob;
+}
 
-	if (group_opened) {
-		m_settings.endGroup();
+bool QDX::WidgetSerializer::decodeBlob(const QVariant &value, QByteArray &data)
+{
+	const QByteArray blob = value.type() == QVariant::String ? QByteArray::fromBase64(value.toString().toLatin1()) : value.toByteArray();
+	if (blob.size() < BLOB_MAGIC_SIZE + 2 || blob.startsWith(BLOB_MAGIC) == false || quint8(blob.at(BLOB_MAGIC_SIZE)) != BLOB_VERSION) {
+		return false;
+	}
+	data = blob.mid(BLOB_MAGIC_SIZE + 2);
+	if (quint8(blob.at(BLOB_MAGIC_SIZE + 1)) & BLOB_COMPRESSED) {
+		data = qUncompress(data);
+		if (data.isEmpty()) {
+			return false;
+		}
 	}
-
 	return true;
 }
 
-bool QDX::WidgetSerializer::performCascade(QObject *object, bool is_load) const
+static qint64 valueSize(const QVariant &value)
 {
-	if (is_load) {
-		this->load(object);
-	} else {
-		this->save(object);
+	switch (int(value.type())) {
+		case QVariant::String:
+			return value.toString().size() * qint64(sizeof(QChar));
+		case QVariant::ByteArray:
+			return value.toByteArray().size();
+		case QVariant::StringList: {
+			qint64 size = 0;
+			for (const QString &item : value.toStringList()) {
+				size += item.size() * qint64(sizeof(QChar));
+			}
+			return size;
+		}
+		default:
+			return QMetaType::sizeOf(value.userType());
 	}
+}
 
-	if (qobject_cast<QMenu *>(object)) {
-		return true;
+static const QElapsedTimer &reportClock()
+{
+	static QElapsedTimer clock;
+	if (clock.isValid() == false) {
+		clock.start();
 	}
+	return clock;
+}
 
-	QVariant cascadable = object->property(CASCADABLE);
-	if (cascadable.isValid() && cascadable.toBool() == false) {
-		return true;
+bool QDX::WidgetSerializer::perform(const TypeHandler *handler, QObject *object, const QString &name, bool is_load) const
+{
+	if (handler == nullptr) {
+		return false;
 	}
-
-	return this->performChildren(object, is_load);
+	if (m_reporting) {
+		QElapsedTimer timer;
+		timer.start();
+		bool result = is_load ? handler->load(*this, object, name) : handler->save(*this, object, name);
+		m_report.handler_nsecs[handler->type->className()] += timer.nsecsElapsed();
+		return result;
+	}
+	return is_load ? handler->load(*this, object, name) : handler->save(*this, object, name);
 }
 
-bool QDX::WidgetSerializer::performChildren(QObject *object, bool is_load, const QString &group_name) const
+bool QDX::WidgetSerializer::dispatch(const TypeHandler *handler, QObject *object, const QString &name, bool is_load) const
 {
-	if (object == nullptr) {
-		return 0;
+	if (m_virtual_dispatch) {
+		return is_load ? this->load(object, name) : this->save(object, name);
 	}
+	return this->perform(handler, object, name, is_load);
+}
 
-	bool group_opened = false;
+bool QDX::WidgetSerializer::saveCascade(QObject *object, const QString &group_name) const
+{
+	return this->performCascade(object, false, group_name);
+}
 
-	QWidget *widget = qobject_cast<QWidget *>(object);
+bool QDX::WidgetSerializer::loadCascade(QObject *object, const QString &group_name) const
+{
+	return this->performCascade(object, true, group_name);
+}
 
-	if (group_name.isEmpty() == false || (widget && widget->isWindow())) {
-		m_settings.beginGroup(group_name.isEmpty() ? object->objectName() : group_name);
-		group_opened = true;
+QDX::ProfileStorage *QDX::WidgetSerializer::profileStorage() const
+{
+	if (m_profiles || m_transaction) {
+		return m_profiles;
 	}
-
-	this->performChildren(object, is_load);
-
-	if (group_opened) {
-		m_settings.endGroup();
+	m_profiles = new ProfileStorage(*m_storage);
+	m_profiles->addSharedPrefix(QLatin1String(BLOB_GROUP));
+	m_profiles->addSharedPrefix(QLatin1String(BLOB_REFERENCES));
+	if (m_storage->group().isEmpty() == false) {
+		m_profiles->beginGroup(m_storage->group());
 	}
+	m_storage = m_profiles;
+	return m_profiles;
+}
 
-	return true;
+QString QDX::WidgetSerializer::profile() const
+{
+	return m_profiles ? m_profiles->profile() : QString();
 }
 
-bool QDX::WidgetSerializer::performChildren(QObject *object, bool is_load) const
+bool QDX::WidgetSerializer::setProfile(const QString &name) const
 {
-	if (object == nullptr) {
+	ProfileStorage *profiles = this->profileStorage();
+	if (profiles == nullptr) {
 		return false;
 	}
-	if (QTabWidget *tabs = qobject_cast<QTabWidget *>(object)) {
-		return this->performChildren(tabs->findChild<QStackedWidget *>("qt_tabwidget_stackedwidget"), is_load);
-	}
-	QVariant serializable;
-	for (QObject *child : object->children()) {
-		if (child->objectName().startsWith("qt_")) {
-			continue;
-		}
-		serializable = child->property(SERIALIZABLE);
-		if (serializable.isValid() && serializable.toBool() == false) {
-			continue;
-		}
-
-		this->performCascade(child, is_load);
+	if (profiles->profile() != name) {
+		profiles->setProfile(name);
+		this->resetTracking();
 	}
 	return true;
 }
 
-bool QDX::WidgetSerializer::saveWindow(QWidget *widget) const
+QStringList QDX::WidgetSerializer::profiles() const
 {
-	if (widget == nullptr || widget->isWindow() == false) {
+	ProfileStorage *profiles = this->profileStorage();
+	return profiles ? profiles->profiles() : QStringList();
+}
+
+bool QDX::WidgetSerializer::switchProfile(QObject *object, const QString &name, const QString &group_name) const
+{
+	ProfileStorage *profiles = this->profileStorage();
+	if (profiles == nullptr) {
 		return false;
 	}
-	if (widget->windowType() == Qt::Dialog) {
-		m_settings.setValue("_position", widget->pos());
-		m_settings.setValue("_size", widget->size());
-	} else {
-		m_settings.setValue("_geometry", widget->saveGeometry());
+	if (profiles->profile() == name) {
+		return true;
 	}
-	if (const QMainWindow *window = qobject_cast<const QMainWindow *>(widget)) {
-		m_settings.setValue("_state", window->saveState());
+	const QStringList changes = profiles->differences(profiles->profile(), name);
+	this->setProfile(name);
+	if (changes.isEmpty()) {
+		return true;
+	}
+
+	for (const QString &path : changes) {
+		m_profile_changes.insert(path);
+		for (int i = path.indexOf('/'); i >= 0; i = path.indexOf('/', i + 1)) {
+			m_profile_prefixes.insert(path.left(i));
+		}
+	}
+	m_profile_filter = true;
+	bool result = this->loadCascade(object, group_name);
+	m_profile_filter = false;
+	m_profile_changes.clear();
+	m_profile_prefixes.clear();
+	return result;
+}
+
+bool QDX::WidgetSerializer::isFiltered(const QString &key) const
+{
+	const QString &path = this->fullPath(key);
+	return m_profile_changes.contains(path) == false && m_profile_prefixes.contains(path) == false;
+}
+
+QDX::CascadeTask *QDX::WidgetSerializer::saveCascadeAsync(QObject *object, const QString &group_name) const
+{
+	CascadeTask *task = new CascadeTask(*this, object, false, group_name);
+	QTimer::singleShot(0, task, &CascadeTask::start);
+	return task;
+}
+
+QDX::CascadeTask *QDX::WidgetSerializer::loadCascadeAsync(QObject *object, const QString &group_name) const
+{
+	CascadeTask *task = new CascadeTask(*this, object, true, group_name);
+	QTimer::singleShot(0, task, &CascadeTask::start);
+	return task;
+}
+
+bool QDX::WidgetSerializer::saveChildren(QObject *object, const QString &group_name) const
+{
+	return this->performChildren(object, false, group_name);
+}
+
+bool QDX::WidgetSerializer::loadChildren(QObject *object, const QString &group_name) const
+{
+	return this->performChildren(object, true, group_name);
+}
+
+bool QDX::WidgetSerializer::performCascade(QObject *object, bool is_load, const QString &group_name) const
+{
+	if (object == nullptr) {
+		return 0;
+	}
+
+	Cascade cascade = this->beginCascade(object, is_load, group_name);
+
+	if (this->omitWindow() == false) {
+		if (is_load) {
+			this->loadWindow(qobject_cast<QWidget *>(object));
+		} else {
+			this->saveWindow(qobject_cast<QWidget *>(object));
+		}
+	}
+
+	if (m_cache_plans || (is_load && m_lazy_load) || m_shared_templates) {
+		this->performPlan(this->plan(object), is_load);
+	} else {
+		this->performCascade(object, is_load);
+	}
+
+	this->endCascade(cascade);
+
+	return true;
+}
+
+bool QDX::WidgetSerializer::performCascade(QObject *object, bool is_load) const
+{
+	if (m_reporting) {
+		++m_report.nodes_visited;
+	}
+
+	if (m_lazy_restores.isEmpty() == false) {
+		if (is_load) {
+			this->undefer(object);
+		} else if (m_lazy_restores.contains(object)) {
+			if (m_reporting) {
+				++m_report.skipped_deferred;
+			}
+			if (m_collect_keys) {
+				SerializationPlan plan(object);
+				plan.setWatching(false);
+				this->preparePlan(plan);
+				this->collectEntries(plan, 0, plan.entries().size());
+			}
+			return true;
+		}
+	}
+
+	if (is_load) {
+		QSignalBlocker blocker(m_suppress_signals ? object : nullptr);
+		this->load(object);
+	} else {
+		this->save(object);
+	}
+
+	if (qobject_cast<QMenu *>(object)) {
+		if (m_reporting) {
+			++m_report.skipped_menu;
+		}
+		return true;
+	}
+
+	QVariant cascadable = object->property(CASCADABLE);
+	if (cascadable.isValid() && cascadable.toBool() == false) {
+		if (m_reporting) {
+			++m_report.skipped_cascadable;
+		}
+		return true;
+	}
+
+	return this->performChildren(object, is_load);
+}
+
+bool QDX::WidgetSerializer::performChildren(QObject *object, bool is_load, const QString &group_name) const
+{
+	if (object == nullptr) {
+		return 0;
+	}
+
+	Cascade cascade = this->beginCascade(object, is_load, group_name);
+
+	this->performChildren(object, is_load);
+
+	this->endCascade(cascade);
+
+	return true;
+}
+
+bool QDX::WidgetSerializer::performChildren(QObject *object, bool is_load) const
+{
+	if (object == nullptr) {
+		return false;
+	}
+	if (QTabWidget *tabs = qobject_cast<QTabWidget *>(object)) {
+		return this->performChildren(tabs->findChild<QStackedWidget *>("qt_tabwidget_stackedwidget"), is_load);
+	}
+	QVariant serializable;
+	for (QObject *child : object->children()) {
+		if (child->objectName().startsWith("qt_")) {
+			if (m_reporting) {
+				++m_report.skipped_internal;
+			}
+			continue;
+		}
+		serializable = child->property(SERIALIZABLE);
+		if (serializable.isValid() && serializable.toBool() == false) {
+			if (m_reporting) {
+				++m_report.skipped_serializable;
+			}
+			continue;
+		}
+
+		this->performCascade(child, is_load);
+	}
+	return true;
+}
+
+static bool isPageHidden(QObject *object)
+{
+	QWidget *widget = qobject_cast<QWidget *>(object);
+	if (widget == nullptr) {
+		return false;
+	}
+	if (QStackedWidget *stack = qobject_cast<QStackedWidget *>(widget->parentWidget())) {
+		return stack->currentWidget() != widget;
+	}
+	return widget->isHidden() && widget->testAttribute(Qt::WA_WState_ExplicitShowHide);
+}
+
+bool QDX::WidgetSerializer::performPlan(SerializationPlan *plan, bool is_load) const
+{
+	if (plan == nullptr) {
+		return false;
+	}
+	const QVector<SerializationPlan::Entry> &entries = plan->entries();
+	const QVector<SerializationPlan::Page> &pages = plan->pages();
+	if (m_reporting) {
+		const SerializationPlan::Skipped &skipped = plan->skipped();
+		m_report.nodes_visited += plan->nodeCount();
+		m_report.skipped_internal += skipped.internal;
+		m_report.skipped_serializable += skipped.serializable;
+		m_report.skipped_cascadable += skipped.cascadable;
+		m_report.skipped_menu += skipped.menu;
+	}
+	bool paged = (is_load && m_lazy_load) || m_lazy_restores.isEmpty() == false;
+	bool fingerprinted = is_load == false && m_skip_unchanged && m_collect_keys == false && plan->fingerprinting();
+	const QString group = fingerprinted ? m_storage->group() : QString();
+	int page = 0;
+	for (int i = 0; i < entries.size(); ) {
+		if (paged || fingerprinted) {
+			while (page < pages.size() && pages.at(page).begin < i) {
+				++page;
+			}
+			bool skipped = false;
+			while (page < pages.size() && pages.at(page).begin == i) {
+				int index = page++;
+				const SerializationPlan::Page &current = pages.at(index);
+				if (current.end <= current.begin) {
+					continue;
+				}
+				if (paged && this->skipPage(current.object, plan->root(), is_load)) {
+					if (is_load == false) {
+						this->collectEntries(*plan, current.begin, current.end);
+					}
+					i = current.end;
+					skipped = true;
+					break;
+				}
+				if (fingerprinted && plan->isPageUnchanged(index, group)) {
+					if (m_reporting) {
+						m_report.skipped_unchanged += current.end - current.begin;
+					}
+					i = current.end;
+					skipped = true;
+					break;
+				}
+			}
+			if (skipped) {
+				continue;
+			}
+			if (fingerprinted && plan->isEntryUnchanged(i, group)) {
+				if (m_reporting) {
+					++m_report.skipped_unchanged;
+				}
+				++i;
+				continue;
+			}
+		}
+		const SerializationPlan::Entry &entry = entries.at(i++);
+		QSignalBlocker blocker(is_load && m_suppress_signals ? entry.object : nullptr);
+		this->dispatch(entry.handler.data(), entry.object, entry.key, is_load);
+	}
+	if (fingerprinted) {
+		plan->markSaved(group);
+	}
+	return true;
+}
+
+class QDX::WidgetSerializer::LazyRestore : public QObject
+{
+public:
+	LazyRestore(const WidgetSerializer &serializer, QObject *page, const QString &group) :
+		QObject(page), m_serializer(serializer), m_page(page), m_group(group)
+	{
+		page->installEventFilter(this);
+	}
+
+	~LazyRestore()
+	{
+		this->release();
+	}
+
+	void setGroup(const QString &group)
+	{
+		m_group = group;
+	}
+
+	void release()
+	{
+		if (m_released) {
+			return;
+		}
+		m_released = true;
+		auto found = m_serializer.m_lazy_restores.find(m_page);
+		if (found != m_serializer.m_lazy_restores.end() && found.value() == this) {
+			m_serializer.m_lazy_restores.erase(found);
+		}
+	}
+
+	void run()
+	{
+		if (m_released) {
+			return;
+		}
+		m_page->removeEventFilter(this);
+		this->release();
+		this->restore(m_page);
+		this->deleteLater();
+	}
+
+protected:
+	bool eventFilter(QObject *watched, QEvent *event) override
+	{
+		if (watched == m_page && event->type() == QEvent::Show && m_released == false) {
+			if (m_serializer.m_cascade_depth > 0) {
+				if (m_queued == false) {
+					m_queued = true;
+					m_serializer.m_queued_restores.append(this);
+				}
+			} else {
+				this->run();
+			}
+		}
+		return QObject::eventFilter(watched, event);
+	}
+
+private:
+	const WidgetSerializer &m_serializer;
+	QObject *m_page;
+	QString m_group;
+	bool m_released = false;
+	bool m_queued = false;
+
+	void restore(QObject *page)
+	{
+		Cascade cascade = m_serializer.beginCascade(page, true, m_group, false);
+		SerializationPlan plan(page);
+		plan.setWatching(false);
+		m_serializer.preparePlan(plan);
+		m_serializer.performPlan(&plan, true);
+		m_serializer.endCascade(cascade);
+	}
+};
+
+bool QDX::WidgetSerializer::isDeferred(QObject *object) const
+{
+	if (m_lazy_restores.isEmpty()) {
+		return false;
+	}
+	for (; object; object = object->parent()) {
+		if (m_lazy_restores.contains(object)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void QDX::WidgetSerializer::defer(QObject *page) const
+{
+	LazyRestore *&restore = m_lazy_restores[page];
+	if (restore) {
+		restore->setGroup(m_storage->group());
+	} else {
+		restore = new LazyRestore(*this, page, m_storage->group());
+	}
+}
+
+void QDX::WidgetSerializer::undefer(QObject *page) const
+{
+	LazyRestore *restore = m_lazy_restores.take(page);
+	if (restore) {
+		restore->release();
+		delete restore;
+	}
+}
+
+bool QDX::WidgetSerializer::skipPage(QObject *page, QObject *root, bool is_load) const
+{
+	if (is_load) {
+		if (m_lazy_load && page != root && isPageHidden(page)) {
+			this->defer(page);
+			if (m_reporting) {
+				++m_report.skipped_deferred;
+			}
+			return true;
+		}
+		this->undefer(page);
+		return false;
+	}
+	if (m_lazy_restores.contains(page)) {
+		if (m_reporting) {
+			++m_report.skipped_deferred;
+		}
+		return true;
+	}
+	return false;
+}
+
+QDX::WidgetSerializer::Cascade QDX::WidgetSerializer::beginCascade(QObject *object, bool is_load, const QString &group_name, bool window_group) const
+{
+	Cascade cascade;
+	++m_cascade_depth;
+
+	QWidget *widget = qobject_cast<QWidget *>(object);
+
+	if (group_name.isEmpty() == false || (window_group && widget && widget->isWindow())) {
+		m_storage->beginGroup(group_name.isEmpty() ? object->objectName() : group_name);
+		cascade.group_opened = true;
+	}
+
+	if (m_instrumentation && m_reporting == false) {
+		m_reporting = true;
+		m_report = Report();
+		m_report.is_load = is_load;
+		m_report_started = reportClock().nsecsElapsed();
+		cascade.reporting = true;
+		cascade.report_group = m_storage->group();
+	}
+
+	if (is_load) {
+		if (m_skip_unchanged) {
+			for (SerializationPlan *plan : qAsConst(m_plans)) {
+				plan->resetFingerprints();
+			}
+		}
+		cascade.prefetched = this->beginPrefetch();
+		if (m_suppress_updates && widget && widget->updatesEnabled()) {
+			widget->setUpdatesEnabled(false);
+			cascade.suppressed = widget;
+		}
+		if (m_restored_callback && m_restoring == false) {
+			m_restoring = true;
+			m_restored.clear();
+			cascade.restoring = true;
+		}
+	} else {
+		m_write_count = 0;
+	}
+
+	return cascade;
+}
+
+void QDX::WidgetSerializer::endCascade(const Cascade &cascade) const
+{
+	if (cascade.prefetched) {
+		this->endPrefetch();
+	}
+
+	if (cascade.group_opened) {
+		m_storage->endGroup();
+	}
+
+	if (cascade.suppressed) {
+		cascade.suppressed->setUpdatesEnabled(true);
+	}
+
+	if (cascade.restoring) {
+		m_restoring = false;
+		QList<QObject *> restored;
+		restored.swap(m_restored);
+		m_restored_callback(restored);
+	}
+
+	if (cascade.reporting) {
+		m_reporting = false;
+		m_report.elapsed_nsecs = reportClock().nsecsElapsed() - m_report_started;
+		m_report.group_nsecs[cascade.report_group] += m_report.elapsed_nsecs;
+		m_last_report = m_report;
+		if (m_report_callback) {
+			m_report_callback(m_last_report);
+		}
+	}
+
+	if (--m_cascade_depth == 0) {
+		this->trimKeys();
+		while (m_queued_restores.isEmpty() == false) {
+			QPointer<LazyRestore> restore = m_queued_restores.takeFirst();
+			if (restore) {
+				restore->run();
+			}
+		}
+	}
+}
+
+void QDX::WidgetSerializer::restored(QObject *object) const
+{
+	if (m_restoring) {
+		m_restored.append(object);
+	}
+}
+
+bool QDX::WidgetSerializer::saveWindow(QWidget *widget) const
+{
+	if (widget == nullptr || widget->isWindow() == false) {
+		return false;
+	}
+	if (widget->windowType() == Qt::Dialog) {
+		this->write("_position", widget->pos());
+		this->write("_size", widget->size());
+	} else {
+		this->writeBlob("_geometry", widget->saveGeometry());
+	}
+	if (const QMainWindow *window = qobject_cast<const QMainWindow *>(widget)) {
+		this->writeBlob("_state", window->saveState());
+	}
+	return true;
+}
+
+bool QDX::WidgetSerializer::loadWindow(QWidget *widget) const
+{
+	if (widget == nullptr || widget->isWindow() == false) {
+		return false;
+	}
+	bool changed = false;
+	QVariant value;
+	QByteArray data;
+	if (widget->windowType() == Qt::Dialog) {
+		if (this->read("_position", value) && widget->pos() != value.toPoint()) {
+			widget->move(value.toPoint());
+			changed = true;
+		}
+		if (this->read("_size", value) && widget->size() != value.toSize()) {
+			widget->resize(value.toSize());
+			changed = true;
+		}
+	} else {
+		if (this->readBlob("_geometry", data) && widget->saveGeometry() != data) {
+			widget->restoreGeometry(data);
+			changed = true;
+		}
+	}
+	if (QMainWindow *window = qobject_cast<QMainWindow *>(widget)) {
+		if (this->readBlob("_state", data) && window->saveState() != data) {
+			window->restoreState(data);
+			changed = true;
+		}
+	}
+	if (changed) {
+		this->restored(widget);
+	}
+	return true;
+}
+
+bool QDX::WidgetSerializer::read(const QString &key, QVariant &value) const
+{
+	if (m_profile_filter && this->isFiltered(key)) {
+		return false;
+	}
+	if (m_prefetched) {
+		auto it = m_prefetch_values.constFind(key);
+		if (it == m_prefetch_values.constEnd()) {
+			return false;
+		}
+		value = it.value();
+	} else {
+		value = m_storage->read(this->fullPath(key));
+		if (value.isValid() == false) {
+			return false;
+		}
+	}
+	if (m_reporting) {
+		++m_report.keys_read;
+	}
+	if (m_track_changes) {
+		m_tracked_values.insert(this->trackedKey(key), value);
+	}
+	return true;
+}
+
+void QDX::WidgetSerializer::write(const QString &key, const QVariant &value) const
+{
+	this->collect(key);
+	if (m_track_changes) {
+		const QString tracked_key = this->trackedKey(key);
+		auto it = m_tracked_values.find(tracked_key);
+		if (it != m_tracked_values.end()) {
+			if (it.value() == value) {
+				return;
+			}
+			it.value() = value;
+		} else {
+			m_tracked_values.insert(tracked_key, value);
+		}
+	}
+	this->writePath(this->fullPath(key), value);
+}
+
+static bool readStored(const QDX::Storage &storage, const QString &path, bool &value)
+{
+	return storage.readBool(path, value);
+}
+
+static bool readStored(const QDX::Storage &storage, const QString &path, int &value)
+{
+	return storage.readInt(path, value);
+}
+
+static bool readStored(const QDX::Storage &storage, const QString &path, double &value)
+{
+	return storage.readDouble(path, value);
+}
+
+static bool readStored(const QDX::Storage &storage, const QString &path, QString &value)
+{
+	return storage.readString(path, value);
+}
+
+static bool readStored(const QDX::Storage &storage, const QString &path, QByteArray &value)
+{
+	return storage.readBytes(path, value);
+}
+
+static void writeStored(QDX::Storage &storage, const QString &path, bool value)
+{
+	storage.writeBool(path, value);
+}
+
+static void writeStored(QDX::Storage &storage, const QString &path, int value)
+{
+	storage.writeInt(path, value);
+}
+
+static void writeStored(QDX::Storage &storage, const QString &path, double value)
+{
+	storage.writeDouble(path, value);
+}
+
+static void writeStored(QDX::Storage &storage, const QString &path, const QString &value)
+{
+	storage.writeString(path, value);
+}
+
+static void writeStored(QDX::Storage &storage, const QString &path, const QByteArray &value)
+{
+	storage.writeBytes(path, value);
+}
+
+template <typename T>
+bool QDX::WidgetSerializer::readTyped(const QString &key, T &value) const
+{
+	if (m_prefetched || m_track_changes) {
+		QVariant stored;
+		if (this->read(key, stored) == false) {
+			return false;
+		}
+		value = stored.value<T>();
+		return true;
+	}
+	if (m_profile_filter && this->isFiltered(key)) {
+		return false;
+	}
+	if (readStored(*m_storage, this->fullPath(key), value) == false) {
+		return false;
+	}
+	if (m_reporting) {
+		++m_report.keys_read;
+	}
+	return true;
+}
+
+template <typename T>
+void QDX::WidgetSerializer::writeTyped(const QString &key, const T &value) const
+{
+	if (m_track_changes) {
+		this->write(key, value);
+		return;
+	}
+	this->collect(key);
+	writeStored(*m_storage, this->fullPath(key), value);
+	++m_write_count;
+	if (m_reporting) {
+		++m_report.keys_written;
+		m_report.bytes_written += valueSize(value);
+	}
+}
+
+bool QDX::WidgetSerializer::readBool(const QString &key, bool &value) const
+{
+	return this->readTyped(key, value);
+}
+
+bool QDX::WidgetSerializer::readInt(const QString &key, int &value) const
+{
+	return this->readTyped(key, value);
+}
+
+bool QDX::WidgetSerializer::readDouble(const QString &key, double &value) const
+{
+	return this->readTyped(key, value);
+}
+
+bool QDX::WidgetSerializer::readString(const QString &key, QString &value) const
+{
+	return this->readTyped(key, value);
+}
+
+bool QDX::WidgetSerializer::readBytes(const QString &key, QByteArray &value) const
+{
+	return this->readTyped(key, value);
+}
+
+void QDX::WidgetSerializer::writeBool(const QString &key, bool value) const
+{
+	this->writeTyped(key, value);
+}
+
+void QDX::WidgetSerializer::writeInt(const QString &key, int value) const
+{
+	this->writeTyped(key, value);
+}
+
+void QDX::WidgetSerializer::writeDouble(const QString &key, double value) const
+{
+	this->writeTyped(key, value);
+}
+
+void QDX::WidgetSerializer::writeString(const QString &key, const QString &value) const
+{
+	this->writeTyped(key, value);
+}
+
+void QDX::WidgetSerializer::writeBytes(const QString &key, const QByteArray &value) const
+{
+	this->writeTyped(key, value);
+}
+
+bool QDX::WidgetSerializer::readBlob(const QString &key, QByteArray &data) const
+{
+	QVariant value;
+	if (this->read(key, value) == false) {
+		return false;
+	}
+	if (value.type() != QVariant::String || value.toString().startsWith(QLatin1String(BLOB_REFERENCE)) == false) {
+		data = value.toByteArray();
+		return true;
+	}
+	const QByteArray hash = value.toString().mid(BLOB_REFERENCE_SIZE).toLatin1();
+	auto it = m_blobs.constFind(hash);
+	if (it == m_blobs.constEnd()) {
+		if (decodeBlob(m_storage->read(QLatin1String(BLOB_GROUP) + QString::fromLatin1(hash)), data) == false) {
+			return false;
+		}
+		it = m_blobs.insert(hash, data);
+		if (m_reporting) {
+			++m_report.keys_read;
+		}
+	}
+	data = it.value();
+	return true;
+}
+
+void QDX::WidgetSerializer::writeBlob(const QString &key, const QByteArray &data) const
+{
+	if (m_dedup_blobs == false) {
+		this->write(key, data);
+		return;
+	}
+	const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+	const QString reference = QLatin1String(BLOB_REFERENCE) + QString::fromLatin1(hash);
+
+	QVariant previous;
+	auto tracked = m_track_changes ? m_tracked_values.constFind(this->trackedKey(key)) : m_tracked_values.constEnd();
+	if (tracked != m_tracked_values.constEnd()) {
+		previous = tracked.value();
+	} else {
+		previous = m_storage->read(this->fullPath(key));
+	}
+	const QString previous_reference = previous.type() == QVariant::String ? previous.toString() : QString();
+	// A profile value inherited from the base layer is not a reference held by this profile.
+	const bool inherited = m_profiles && m_profiles->isInherited(this->fullPath(key));
+
+	this->write(key, reference);
+	// Outside a transaction the profile layer tells whether the reference was actually stored.
+	const bool stored = m_profiles == nullptr || m_transaction || m_profiles->isInherited(this->fullPath(key)) == false;
+	if (stored && (previous_reference != reference || m_storage->read(QLatin1String(BLOB_GROUP) + QString::fromLatin1(hash)).isValid() == false)) {
+		this->acquireBlob(hash, data);
+	}
+	if (inherited == false && previous_reference != reference && previous_reference.startsWith(QLatin1String(BLOB_REFERENCE))) {
+		this->releaseBlob(previous_reference.mid(BLOB_REFERENCE_SIZE).toLatin1());
 	}
-	return true;
 }
 
-bool QDX::WidgetSerializer::loadWindow(QWidget *widget) const
+void QDX::WidgetSerializer::acquireBlob(const QByteArray &hash, const QByteArray &data) const
 {
-	if (widget == nullptr || widget->isWindow() == false) {
-		return false;
-	}
-	if (widget->windowType() == Qt::Dialog) {
-		if (m_settings.contains("_position")) {
-			widget->move(m_settings.value("_position").toPoint());
-		}
-		if (m_settings.contains("_size")) {
-			widget->resize(m_settings.value("_size").toSize());
+	const QString blob_path = QLatin1String(BLOB_GROUP) + QString::fromLatin1(hash);
+	const QString references_path = QLatin1String(BLOB_REFERENCES) + QString::fromLatin1(hash);
+	const QVariant references = m_storage->read(references_path);
+	bool stored = m_storage->read(blob_path).isValid();
+	if (stored == false) {
+		QVariant value = encodeBlob(data, m_blob_compression);
+		if (this->backingSettings()) {
+			value = QString::fromLatin1(value.toByteArray().toBase64());
 		}
+		this->writePath(blob_path, value);
+		m_blobs.insert(hash, data);
+	}
+	if (stored == false || references.isValid()) {
+		this->writePath(references_path, stored ? references.toInt() + 1 : 1);
+	}
+}
+
+void QDX::WidgetSerializer::releaseBlob(const QByteArray &hash) const
+{
+	const QString references_path = QLatin1String(BLOB_REFERENCES) + QString::fromLatin1(hash);
+	const QVariant references = m_storage->read(references_path);
+	if (references.isValid() == false) {
+		return;
+	}
+	int count = references.toInt() - 1;
+	if (count > 0) {
+		this->writePath(references_path, count);
+		return;
+	}
+	m_storage->erase(QLatin1String(BLOB_GROUP) + QString::fromLatin1(hash));
+	m_storage->erase(references_path);
+	m_blobs.remove(hash);
+}
+
+void QDX::WidgetSerializer::writePath(const QString &path, const QVariant &value) const
+{
+	m_storage->write(path, value);
+	++m_write_count;
+	if (m_reporting) {
+		++m_report.keys_written;
+		m_report.bytes_written += valueSize(value);
+	}
+}
+
+QString QDX::WidgetSerializer::trackedKey(const QString &key) const
+{
+	return this->fullPath(key);
+}
+
+static const int MAX_KEY_GROUPS = 256;
+static const int MAX_GROUP_KEYS = 4096;
+
+void QDX::WidgetSerializer::trimKeys() const
+{
+	if (m_keys.paths.size() > MAX_KEY_GROUPS) {
+		m_keys.paths.clear();
+		m_keys.current = nullptr;
 	} else {
-		if (m_settings.contains("_geometry")) {
-			widget->restoreGeometry(m_settings.value("_geometry").toByteArray());
+		for (auto it = m_keys.paths.begin(); it != m_keys.paths.end(); ) {
+			if (it.value().size() > MAX_GROUP_KEYS) {
+				if (m_keys.current == &it.value()) {
+					m_keys.current = nullptr;
+				}
+				it = m_keys.paths.erase(it);
+			} else {
+				++it;
+			}
 		}
 	}
-	if (QMainWindow *window = qobject_cast<QMainWindow *>(widget)) {
-		if (m_settings.contains("_state")) {
-			window->restoreState(m_settings.value("_state").toByteArray());
-		}
+	if (m_keys.items.size() > MAX_GROUP_KEYS) {
+		m_keys.items.clear();
+	}
+	if (m_keys.actions.size() > MAX_GROUP_KEYS) {
+		m_keys.actions.clear();
+	}
+}
+
+const QString &QDX::WidgetSerializer::fullPath(const QString &key) const
+{
+	if (m_keys.current == nullptr || m_keys.group != m_storage->group()) {
+		m_keys.group = m_storage->group();
+		m_keys.current = &m_keys.paths[m_keys.group];
+	}
+	QHash<QString, QString> &paths = *m_keys.current;
+	auto it = paths.constFind(key);
+	if (it == paths.constEnd()) {
+		it = paths.insert(key, m_storage->path(key));
+	}
+	return it.value();
+}
+
+const QString &QDX::WidgetSerializer::itemsKey(const QString &key) const
+{
+	auto it = m_keys.items.constFind(key);
+	if (it == m_keys.items.constEnd()) {
+		it = m_keys.items.insert(key, key + ".items");
+	}
+	return it.value();
+}
+
+const QString &QDX::WidgetSerializer::actionKey(const QString &name) const
+{
+	auto it = m_keys.actions.constFind(name);
+	if (it == m_keys.actions.constEnd()) {
+		it = m_keys.actions.insert(name, purifyActionName(name));
+	}
+	return it.value();
+}
+
+bool QDX::WidgetSerializer::beginPrefetch() const
+{
+	if (m_prefetch == false || m_prefetched) {
+		return false;
 	}
+	const QStringList keys = m_storage->allKeys();
+	m_prefetch_values.reserve(keys.size());
+	for (const QString &key : keys) {
+		m_prefetch_values.insert(key, m_storage->value(key));
+	}
+	m_prefetched = true;
 	return true;
 }
 
+void QDX::WidgetSerializer::endPrefetch() const
+{
+	m_prefetch_values.clear();
+	m_prefetched = false;
+}
+
 bool QDX::WidgetSerializer::omitHistory() const
 {
 	return m_omit_history;
@@ -557,6 +1872,48 @@ void QDX::WidgetSerializer::setOmitHistory(bool omit_history)
 	m_omit_history = omit_history;
 }
 
+bool QDX::WidgetSerializer::compactHistory() const
+{
+	return m_compact_history;
+}
+
+void QDX::WidgetSerializer::setCompactHistory(bool compact_history)
+{
+	m_compact_history = compact_history;
+	m_tracked_histories.clear();
+}
+
+bool QDX::WidgetSerializer::historyCompression() const
+{
+	return m_history_compression;
+}
+
+void QDX::WidgetSerializer::setHistoryCompression(bool history_compression)
+{
+	m_history_compression = history_compression;
+	m_tracked_histories.clear();
+}
+
+bool QDX::WidgetSerializer::dedupBlobs() const
+{
+	return m_dedup_blobs;
+}
+
+void QDX::WidgetSerializer::setDedupBlobs(bool dedup_blobs)
+{
+	m_dedup_blobs = dedup_blobs;
+}
+
+bool QDX::WidgetSerializer::blobCompression() const
+{
+	return m_blob_compression;
+}
+
+void QDX::WidgetSerializer::setBlobCompression(bool blob_compression)
+{
+	m_blob_compression = blob_compression;
+}
+
 bool QDX::WidgetSerializer::omitWindow() const
 {
 	return m_omit_window;
@@ -567,6 +1924,361 @@ void QDX::WidgetSerializer::setOmitWindow(bool omit_window)
 	m_omit_window = omit_window;
 }
 
+bool QDX::WidgetSerializer::prefetch() const
+{
+	return m_prefetch;
+}
+
+void QDX::WidgetSerializer::setPrefetch(bool prefetch)
+{
+	m_prefetch = prefetch;
+}
+
+bool QDX::WidgetSerializer::trackChanges() const
+{
+	return m_track_changes;
+}
+
+void QDX::WidgetSerializer::setTrackChanges(bool track_changes)
+{
+	m_track_changes = track_changes;
+	if (track_changes == false) {
+		m_tracked_values.clear();
+		m_tracked_histories.clear();
+	}
+}
+
+void QDX::WidgetSerializer::clearTrackedValues()
+{
+	m_tracked_values.clear();
+	m_tracked_histories.clear();
+}
+
+int QDX::WidgetSerializer::writeCount() const
+{
+	return m_write_count;
+}
+
+bool QDX::WidgetSerializer::suppressUpdates() const
+{
+	return m_suppress_updates;
+}
+
+void QDX::WidgetSerializer::setSuppressUpdates(bool suppress_updates)
+{
+	m_suppress_updates = suppress_updates;
+}
+
+bool QDX::WidgetSerializer::suppressSignals() const
+{
+	return m_suppress_signals;
+}
+
+void QDX::WidgetSerializer::setSuppressSignals(bool suppress_signals)
+{
+	m_suppress_signals = suppress_signals;
+}
+
+void QDX::WidgetSerializer::setRestoredCallback(const RestoredCallback &callback)
+{
+	m_restored_callback = callback;
+}
+
+bool QDX::WidgetSerializer::lazyLoad() const
+{
+	return m_lazy_load;
+}
+
+void QDX::WidgetSerializer::setLazyLoad(bool lazy_load)
+{
+	m_lazy_load = lazy_load;
+}
+
+bool QDX::WidgetSerializer::sharedTemplates() const
+{
+	return m_shared_templates;
+}
+
+void QDX::WidgetSerializer::setSharedTemplates(bool shared_templates)
+{
+	m_shared_templates = shared_templates;
+	if (shared_templates == false) {
+		m_templates.clear();
+	}
+}
+
+void QDX::WidgetSerializer::clearTemplates()
+{
+	m_templates.clear();
+}
+
+void QDX::WidgetSerializer::preparePlan(SerializationPlan &plan) const
+{
+	plan.setIncludeUnhandled(m_virtual_dispatch);
+	QObject *root = plan.root();
+	if (m_shared_templates == false || root == nullptr) {
+		plan.compile();
+		return;
+	}
+	QVector<QSharedPointer<const PlanTemplate>> &templates = m_templates[root->metaObject()];
+	int revision = handlersRevision();
+	for (int i = 0; i < templates.size(); ) {
+		if (templates.at(i)->revision != revision) {
+			templates.removeAt(i);
+			continue;
+		}
+		if (plan.bind(*templates.at(i))) {
+			if (i > 0) {
+				templates.move(i, 0);
+			}
+			return;
+		}
+		++i;
+	}
+	plan.compile();
+	QSharedPointer<const PlanTemplate> plan_template = plan.createTemplate();
+	if (plan_template) {
+		templates.prepend(plan_template);
+		if (templates.size() > MAX_TEMPLATES) {
+			templates.removeLast();
+		}
+	}
+}
+
+bool QDX::WidgetSerializer::collectKeys() const
+{
+	return m_collect_keys;
+}
+
+void QDX::WidgetSerializer::setCollectKeys(bool collect_keys)
+{
+	m_collect_keys = collect_keys;
+}
+
+void QDX::WidgetSerializer::clearCollectedKeys()
+{
+	m_collected_keys.clear();
+	m_collected_prefixes.clear();
+}
+
+const QSet<QString> &QDX::WidgetSerializer::collectedKeys() const
+{
+	return m_collected_keys;
+}
+
+void QDX::WidgetSerializer::collect(const QString &key, bool prefix) const
+{
+	if (m_collect_keys == false) {
+		return;
+	}
+	if (prefix) {
+		m_collected_prefixes.insert(this->fullPath(key));
+	} else {
+		m_collected_keys.insert(this->fullPath(key));
+	}
+}
+
+void QDX::WidgetSerializer::collectEntries(const SerializationPlan &plan, int begin, int end) const
+{
+	if (m_collect_keys == false) {
+		return;
+	}
+	const QVector<SerializationPlan::Entry> &entries = plan.entries();
+	for (int i = begin; i < end; ++i) {
+		const QString &key = entries.at(i).key;
+		this->collect(key);
+		this->collect(key, true);
+		this->collect(this->itemsKey(key));
+		this->collect(this->actionKey(key));
+	}
+}
+
+qint64 QDX::WidgetSerializer::compact(Storage *archive, int *removed) const
+{
+	return this->compactStorage(m_collected_keys, m_collected_prefixes, archive, removed);
+}
+
+qint64 QDX::WidgetSerializer::compact(const QSet<QString> &keys, Storage *archive, int *removed) const
+{
+	return this->compactStorage(keys, QSet<QString>(), archive, removed);
+}
+
+qint64 QDX::WidgetSerializer::compactStorage(const QSet<QString> &keys, const QSet<QString> &prefixes, Storage *archive, int *removed) const
+{
+	if (keys.isEmpty() && prefixes.isEmpty()) {
+		if (removed) {
+			*removed = 0;
+		}
+		return 0;
+	}
+	qint64 saved = m_storage->compact([&keys, &prefixes](const QString &path) {
+		if (keys.contains(path) || isBlobPath(path)) {
+			return true;
+		}
+		if (prefixes.isEmpty()) {
+			return false;
+		}
+		if (prefixes.contains(path)) {
+			return true;
+		}
+		for (int i = path.lastIndexOf('/'); i > 0; i = path.lastIndexOf('/', i - 1)) {
+			if (prefixes.contains(path.left(i))) {
+				return true;
+			}
+		}
+		return false;
+	}, archive, removed);
+	m_blobs.clear();
+	return saved + this->compactBlobs(archive, removed);
+}
+
+static void countReferences(const QDX::Storage &storage, QHash<QString, int> &references)
+{
+	for (const QString &path : storage.keys()) {
+		if (isBlobPath(path)) {
+			continue;
+		}
+		const QVariant value = storage.read(path);
+		if (value.type() == QVariant::String && value.toString().startsWith(QLatin1String(BLOB_REFERENCE))) {
+			++references[value.toString().mid(BLOB_REFERENCE_SIZE)];
+		}
+	}
+}
+
+qint64 QDX::WidgetSerializer::compactBlobs(Storage *archive, int *removed) const
+{
+	QHash<QString, int> references;
+	countReferences(m_profiles ? m_profiles->base() : *m_storage, references);
+	if (m_profiles && m_transaction) {
+		QHash<QString, int> pending;
+		countReferences(*m_storage, pending);
+		for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+			int &count = references[it.key()];
+			count = qMax(count, it.value());
+		}
+	}
+
+	QSet<QString> orphans;
+	for (const QString &hash : m_storage->keys(QLatin1String(BLOB_GROUP_NAME))) {
+		const QString references_path = QLatin1String(BLOB_REFERENCES) + hash;
+		const int count = references.value(hash);
+		if (count == 0) {
+			orphans.insert(QLatin1String(BLOB_GROUP) + hash);
+			orphans.insert(references_path);
+			continue;
+		}
+		const QVariant stored = m_storage->read(references_path);
+		if (stored.isValid() == false || stored.toInt() != count) {
+			m_storage->write(references_path, count);
+		}
+	}
+	for (const QString &hash : m_storage->keys(QLatin1String(BLOB_REFERENCES_NAME))) {
+		if (m_storage->read(QLatin1String(BLOB_GROUP) + hash).isValid() == false) {
+			orphans.insert(QLatin1String(BLOB_REFERENCES) + hash);
+		}
+	}
+	if (orphans.isEmpty()) {
+		return 0;
+	}
+
+	int orphans_removed = 0;
+	qint64 saved = m_storage->compact([&orphans](const QString &path) {
+		return orphans.contains(path) == false;
+	}, archive, &orphans_removed);
+	if (removed) {
+		*removed += orphans_removed;
+	}
+	return saved;
+}
+
+bool QDX::WidgetSerializer::skipUnchanged() const
+{
+	return m_skip_unchanged;
+}
+
+void QDX::WidgetSerializer::setSkipUnchanged(bool skip_unchanged)
+{
+	m_skip_unchanged = skip_unchanged;
+}
+
+bool QDX::WidgetSerializer::cachePlans() const
+{
+	return m_cache_plans;
+}
+
+void QDX::WidgetSerializer::setCachePlans(bool cache_plans)
+{
+	m_cache_plans = cache_plans;
+	if (cache_plans == false) {
+		qDeleteAll(m_plans);
+		m_plans.clear();
+	}
+}
+
+bool QDX::WidgetSerializer::virtualDispatch() const
+{
+	return m_virtual_dispatch;
+}
+
+void QDX::WidgetSerializer::setVirtualDispatch(bool virtual_dispatch)
+{
+	if (m_virtual_dispatch != virtual_dispatch) {
+		m_virtual_dispatch = virtual_dispatch;
+		m_templates.clear();
+	}
+}
+
+QDX::SerializationPlan *QDX::WidgetSerializer::plan(QObject *object) const
+{
+	if (object == nullptr) {
+		return nullptr;
+	}
+	SerializationPlan *plan = m_plans.value(object);
+	if (plan && plan->root() != object) {
+		m_plans.remove(object);
+		delete plan;
+		plan = nullptr;
+	}
+	if (plan == nullptr) {
+		for (auto it = m_plans.begin(); it != m_plans.end(); ) {
+			if (it.value()->root() == nullptr) {
+				delete it.value();
+				it = m_plans.erase(it);
+			} else {
+				++it;
+			}
+		}
+		plan = new SerializationPlan(object);
+		m_plans.insert(object, plan);
+	}
+	plan->setFingerprinting(m_skip_unchanged);
+	plan->setIncludeUnhandled(m_virtual_dispatch);
+	if (plan->isValid() == false) {
+		this->preparePlan(*plan);
+	}
+	return plan;
+}
+
+bool QDX::WidgetSerializer::instrumentation() const
+{
+	return m_instrumentation;
+}
+
+void QDX::WidgetSerializer::setInstrumentation(bool instrumentation)
+{
+	m_instrumentation = instrumentation;
+}
+
+void QDX::WidgetSerializer::setReportCallback(const ReportCallback &callback)
+{
+	m_report_callback = callback;
+}
+
+const QDX::WidgetSerializer::Report &QDX::WidgetSerializer::report() const
+{
+	return m_last_report;
+}
+
 void QDX::WidgetSerializer::disableSerialization(QWidget *widget)
 {
 	toggleSerialization(widget, false);
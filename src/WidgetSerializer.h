@@ -18,24 +18,104 @@ class QMenu;
 class QStackedWidget;
 class QAction;
 class QActionGroup;
+struct QMetaObject;
 
 #include <QString>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVariant>
+#include <QVector>
+#include <QList>
+#include <QPointer>
+#include <QMetaMethod>
+
+#include <functional>
 
 namespace QDX {
 
 	class SerializableWidget;
+	class Storage;
+	class TransactionStorage;
+	class ProfileStorage;
+	class SerializationPlan;
+	struct PlanTemplate;
+	class CascadeTask;
+	class AutoSaver;
 
 	class WidgetSerializer
 	{
 	public:
 		WidgetSerializer(QSettings &settings);
+		WidgetSerializer(Storage &storage);
 		virtual ~WidgetSerializer();
 
 		static constexpr const char* SERIALIZABLE = "serializable";
 		static constexpr const char* HISTORY = "history";
 		static constexpr const char* CASCADABLE = "cascadable";
 
+		typedef std::function<bool (const WidgetSerializer &serializer, QObject *object, const QString &name)> Handler;
+
+		struct TypeHandler
+		{
+			Handler save;
+			Handler load;
+			QVector<QMetaMethod> notifiers;
+			const QMetaObject *type;
+		};
+
+		static void registerHandler(const QMetaObject &meta_object, const Handler &save, const Handler &load, const QList<QByteArray> &notifiers = QList<QByteArray>());
+		static void unregisterHandler(const QMetaObject &meta_object);
+		static QSharedPointer<const TypeHandler> findHandler(const QMetaObject *meta_object);
+		static int handlersRevision();
+
+		typedef std::function<void (const QList<QObject *> &objects)> RestoredCallback;
+
+		struct Report
+		{
+			bool is_load = false;
+			int nodes_visited = 0;
+			int skipped_internal = 0;
+			int skipped_serializable = 0;
+			int skipped_cascadable = 0;
+			int skipped_menu = 0;
+			int skipped_deferred = 0;
+			int skipped_unchanged = 0;
+			int keys_read = 0;
+			int keys_written = 0;
+			qint64 bytes_written = 0;
+			qint64 elapsed_nsecs = 0;
+			QHash<QByteArray, qint64> handler_nsecs;
+			QHash<QString, qint64> group_nsecs;
+		};
+
+		typedef std::function<void (const Report &report)> ReportCallback;
+
+		Storage &storage() const;
 		QSettings &settings() const;
+		QSettings *backingSettings() const;
+
+		bool readBool(const QString &key, bool &value) const;
+		bool readInt(const QString &key, int &value) const;
+		bool readDouble(const QString &key, double &value) const;
+		bool readString(const QString &key, QString &value) const;
+		bool readBytes(const QString &key, QByteArray &value) const;
+
+		void writeBool(const QString &key, bool value) const;
+		void writeInt(const QString &key, int value) const;
+		void writeDouble(const QString &key, double value) const;
+		void writeString(const QString &key, const QString &value) const;
+		void writeBytes(const QString &key, const QByteArray &value) const;
+
+		bool beginTransaction() const;
+		bool commit() const;
+		void rollback() const;
+		bool inTransaction() const;
+
+		QString profile() const;
+		bool setProfile(const QString &name) const;
+		QStringList profiles() const;
+		bool switchProfile(QObject *object, const QString &name, const QString &group_name = QString()) const;
 
 		virtual bool save(QCheckBox *widget, const QString &name = QString()) const;
 		virtual bool load(QCheckBox *widget, const QString &name = QString()) const;
@@ -82,6 +162,9 @@ namespace QDX {
 		virtual bool saveCascade(QObject *object, const QString &group_name = QString()) const;
 		virtual bool loadCascade(QObject *object, const QString &group_name = QString()) const;
 
+		CascadeTask *saveCascadeAsync(QObject *object, const QString &group_name = QString()) const;
+		CascadeTask *loadCascadeAsync(QObject *object, const QString &group_name = QString()) const;
+
 		virtual bool saveChildren(QObject *object, const QString &group_name = QString()) const;
 		virtual bool loadChildren(QObject *object, const QString &group_name = QString()) const;
 
@@ -91,9 +174,75 @@ namespace QDX {
 		bool omitHistory() const;
 		void setOmitHistory(bool omit_history);
 
+		bool compactHistory() const;
+		void setCompactHistory(bool compact_history);
+
+		bool historyCompression() const;
+		void setHistoryCompression(bool history_compression);
+
+		static QByteArray encodeHistory(const QStringList &items, bool compress = false);
+		static bool decodeHistory(const QVariant &value, QStringList &items);
+
+		bool dedupBlobs() const;
+		void setDedupBlobs(bool dedup_blobs);
+
+		bool blobCompression() const;
+		void setBlobCompression(bool blob_compression);
+
+		static QByteArray encodeBlob(const QByteArray &data, bool compress = false);
+		static bool decodeBlob(const QVariant &value, QByteArray &data);
+
 		bool omitWindow() const;
 		void setOmitWindow(bool omit_window);
 
+		bool prefetch() const;
+		void setPrefetch(bool prefetch);
+
+		bool trackChanges() const;
+		void setTrackChanges(bool track_changes);
+		void clearTrackedValues();
+
+		int writeCount() const;
+
+		bool suppressUpdates() const;
+		void setSuppressUpdates(bool suppress_updates);
+
+		bool suppressSignals() const;
+		void setSuppressSignals(bool suppress_signals);
+
+		void setRestoredCallback(const RestoredCallback &callback);
+
+		bool lazyLoad() const;
+		void setLazyLoad(bool lazy_load);
+
+		bool cachePlans() const;
+		void setCachePlans(bool cache_plans);
+
+		bool virtualDispatch() const;
+		void setVirtualDispatch(bool virtual_dispatch);
+
+		bool sharedTemplates() const;
+		void setSharedTemplates(bool shared_templates);
+		void clearTemplates();
+
+		bool collectKeys() const;
+		void setCollectKeys(bool collect_keys);
+		void clearCollectedKeys();
+		const QSet<QString> &collectedKeys() const;
+
+		qint64 compact(Storage *archive = nullptr, int *removed = nullptr) const;
+		qint64 compact(const QSet<QString> &keys, Storage *archive = nullptr, int *removed = nullptr) const;
+
+		bool skipUnchanged() const;
+		void setSkipUnchanged(bool skip_unchanged);
+
+		SerializationPlan *plan(QObject *object) const;
+
+		bool instrumentation() const;
+		void setInstrumentation(bool instrumentation);
+		void setReportCallback(const ReportCallback &callback);
+		const Report &report() const;
+
 		static void disableSerialization(QWidget *widget);
 		static void disableSerialization(const QList<QWidget *> &widgets);
 
@@ -121,11 +270,145 @@ namespace QDX {
 		static int historyLimit(QWidget *widget);
 
 	private:
-		QSettings &m_settings;
+		friend class CascadeTask;
+		friend class AutoSaver;
+		friend class LazyRestore;
+
+		mutable Storage *m_storage;
+		Storage *m_owned_storage = nullptr;
+		mutable TransactionStorage *m_transaction = nullptr;
+		mutable ProfileStorage *m_profiles = nullptr;
+		mutable QList<CascadeTask *> m_tasks;
+
+		mutable QSet<QString> m_profile_changes;
+		mutable QSet<QString> m_profile_prefixes;
+		mutable bool m_profile_filter = false;
+
+		ProfileStorage *profileStorage() const;
+		Storage &backingStorage() const;
+		bool isFiltered(const QString &key) const;
+		void resetTracking() const;
 
 		bool m_omit_history = false;
 		bool m_omit_window = false;
-
+		bool m_compact_history = false;
+		bool m_history_compression = true;
+		bool m_dedup_blobs = false;
+		bool m_blob_compression = true;
+		bool m_cache_plans = false;
+		bool m_virtual_dispatch = false;
+		bool m_prefetch = false;
+		bool m_track_changes = false;
+		bool m_suppress_updates = false;
+		bool m_suppress_signals = false;
+		bool m_lazy_load = false;
+		bool m_skip_unchanged = false;
+		bool m_shared_templates = false;
+		bool m_collect_keys = false;
+		bool m_instrumentation = false;
+
+		class LazyRestore;
+		mutable QHash<QObject *, LazyRestore *> m_lazy_restores;
+		mutable QList<QPointer<LazyRestore>> m_queued_restores;
+
+		bool isDeferred(QObject *object) const;
+
+		RestoredCallback m_restored_callback;
+		mutable QList<QObject *> m_restored;
+		mutable bool m_restoring = false;
+
+		struct Cascade
+		{
+			bool group_opened = false;
+			bool prefetched = false;
+			bool restoring = false;
+			bool reporting = false;
+			QWidget *suppressed = nullptr;
+			QString report_group;
+		};
+
+		ReportCallback m_report_callback;
+		mutable Report m_report;
+		mutable Report m_last_report;
+		mutable bool m_reporting = false;
+		mutable qint64 m_report_started = 0;
+
+		mutable QHash<QObject *, SerializationPlan *> m_plans;
+		mutable QHash<const QMetaObject *, QVector<QSharedPointer<const PlanTemplate>>> m_templates;
+
+		void preparePlan(SerializationPlan &plan) const;
+
+		mutable QHash<QString, QVariant> m_prefetch_values;
+		mutable bool m_prefetched = false;
+
+		mutable QHash<QString, QVariant> m_tracked_values;
+		mutable QHash<QString, QStringList> m_tracked_histories;
+
+		mutable QHash<QByteArray, QByteArray> m_blobs;
+
+		mutable QSet<QString> m_collected_keys;
+		mutable QSet<QString> m_collected_prefixes;
+
+		void collect(const QString &key, bool prefix = false) const;
+		void collectEntries(const SerializationPlan &plan, int begin, int end) const;
+		qint64 compactStorage(const QSet<QString> &keys, const QSet<QString> &prefixes, Storage *archive, int *removed) const;
+		qint64 compactBlobs(Storage *archive, int *removed) const;
+
+		mutable int m_write_count = 0;
+
+		struct KeyTable
+		{
+			QHash<QString, QHash<QString, QString>> paths;
+			QHash<QString, QString> items;
+			QHash<QString, QString> actions;
+			QString group;
+			QHash<QString, QString> *current = nullptr;
+		};
+
+		mutable KeyTable m_keys;
+		mutable int m_cascade_depth = 0;
+
+		void trimKeys() const;
+
+		struct ActionIndex
+		{
+			QPointer<QActionGroup> group;
+			QHash<QString, QPointer<QAction>> actions;
+			QPointer<QAction> checked;
+		};
+
+		mutable QHash<const QActionGroup *, ActionIndex> m_action_indexes;
+
+		QAction *groupAction(QActionGroup *group, const QString &name) const;
+
+		const QString &fullPath(const QString &key) const;
+		const QString &itemsKey(const QString &key) const;
+		const QString &actionKey(const QString &name) const;
+
+		bool read(const QString &key, QVariant &value) const;
+		void write(const QString &key, const QVariant &value) const;
+		template <typename T> bool readTyped(const QString &key, T &value) const;
+		template <typename T> void writeTyped(const QString &key, const T &value) const;
+		bool readBlob(const QString &key, QByteArray &data) const;
+		void writeBlob(const QString &key, const QByteArray &data) const;
+		void acquireBlob(const QByteArray &hash, const QByteArray &data) const;
+		void releaseBlob(const QByteArray &hash) const;
+		void writePath(const QString &path, const QVariant &value) const;
+		QString trackedKey(const QString &key) const;
+		bool beginPrefetch() const;
+		void endPrefetch() const;
+
+		bool perform(const TypeHandler *handler, QObject *object, const QString &name, bool is_load) const;
+		bool performObject(QObject *object, const QString &name, bool *casted, bool is_load) const;
+		bool dispatch(const TypeHandler *handler, QObject *object, const QString &name, bool is_load) const;
+		bool performPlan(SerializationPlan *plan, bool is_load) const;
+
+		Cascade beginCascade(QObject *object, bool is_load, const QString &group_name, bool window_group = true) const;
+		void endCascade(const Cascade &cascade) const;
+		void restored(QObject *object) const;
+		void defer(QObject *page) const;
+		void undefer(QObject *page) const;
+		bool skipPage(QObject *page, QObject *root, bool is_load) const;
 		bool performCascade(QObject *object, bool is_load, const QString &group_name) const;
 		bool performCascade(QObject *object, bool is_load) const;
 		bool performChildren(QObject *object, bool is_load, const QString &group_name) const;
@@ -3,6 +3,32 @@ DEPENDPATH += $$PWD
 
 VPATH += $$PWD
 
-SOURCES += WidgetSerializer.cpp
+SOURCES += WidgetSerializer.cpp \
+  SerializationPlan.cpp \
+  AutoSaver.cpp \
+  CascadeTask.cpp \
+  Storage.cpp \
+  SettingsStorage.cpp \
+  MemoryStorage.cpp \
+  SnapshotStorage.cpp \
+  MappedStorage.cpp \
+  JournalStorage.cpp \
+  BackgroundStorage.cpp \
+  PreloadStorage.cpp \
+  TransactionStorage.cpp \
+  ProfileStorage.cpp
 HEADERS += WidgetSerializer.h \
-  SerializableWidget.h
\ No newline at end of file
+  SerializableWidget.h \
+  SerializationPlan.h \
+  AutoSaver.h \
+  CascadeTask.h \
+  Storage.h \
+  SettingsStorage.h \
+  MemoryStorage.h \
+  SnapshotStorage.h \
+  MappedStorage.h \
+  JournalStorage.h \
+  BackgroundStorage.h \
+  PreloadStorage.h \
+  TransactionStorage.h \
+  ProfileStorage.h
\ No newline at end of file
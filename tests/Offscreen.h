@@ -0,0 +1,15 @@
+#ifndef QDX_TESTS_OFFSCREEN_H
+#define QDX_TESTS_OFFSCREEN_H
+
+#include <QtGlobal>
+
+static void useOffscreenPlatform()
+{
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+}
+
+Q_CONSTRUCTOR_FUNCTION(useOffscreenPlatform)
+
+#endif // QDX_TESTS_OFFSCREEN_H
@@ -0,0 +1,141 @@
+#include <QtTest>
+#include <QSplitter>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/MemoryStorage>
+
+#include "Offscreen.h"
+
+class BlobTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void roundTrip_data();
+	void roundTrip();
+	void corrupt();
+	void deduplicated();
+	void released();
+
+private:
+	static QSplitter *addSplitter(QWidget *parent, const QString &name);
+};
+
+QSplitter *BlobTest::addSplitter(QWidget *parent, const QString &name)
+{
+	QSplitter *splitter = new QSplitter(parent);
+	splitter->setObjectName(name);
+	new QWidget(splitter);
+	new QWidget(splitter);
+	return splitter;
+}
+
+void BlobTest::roundTrip_data()
+{
+	QTest::addColumn<QByteArray>("data");
+	QTest::addColumn<bool>("compress");
+
+	QTest::newRow("empty") << QByteArray() << true;
+	QTest::newRow("small") << QByteArray("\x00\x01\x02", 3) << true;
+	QTest::newRow("large") << QByteArray(4096, 'z') << false;
+	QTest::newRow("large compressed") << QByteArray(4096, 'z') << true;
+}
+
+void BlobTest::roundTrip()
+{
+	QFETCH(QByteArray, data);
+	QFETCH(bool, compress);
+
+	const QByteArray blob = QDX::WidgetSerializer::encodeBlob(data, compress);
+	QVERIFY(blob.startsWith("QDXB"));
+
+	QByteArray decoded;
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(blob, decoded));
+	QCOMPARE(decoded, data);
+
+	decoded.clear();
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(QString::fromLatin1(blob.toBase64()), decoded));
+	QCOMPARE(decoded, data);
+}
+
+void BlobTest::corrupt()
+{
+	const QByteArray blob = QDX::WidgetSerializer::encodeBlob(QByteArray(4096, 'z'), true);
+	QByteArray decoded;
+
+	for (int size = 0; size < 6; ++size) {
+		QVERIFY(QDX::WidgetSerializer::decodeBlob(blob.left(size), decoded) == false);
+	}
+
+	QByteArray magic = blob;
+	magic[3] = 'H';
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(magic, decoded) == false);
+
+	QByteArray version = blob;
+	version[4] = char(0);
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(version, decoded) == false);
+
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(blob.left(blob.size() / 2), decoded) == false);
+
+	QByteArray garbage = QByteArray("QDXB") + char(1) + char(0x01) + QByteArray(32, char(0xAB));
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(garbage, decoded) == false);
+
+	QVERIFY(QDX::WidgetSerializer::decodeBlob(QString("not a blob"), decoded) == false);
+}
+
+void BlobTest::deduplicated()
+{
+	QWidget root;
+	root.setObjectName("root");
+	addSplitter(&root, "left");
+	QSplitter *right = addSplitter(&root, "right");
+
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setDedupBlobs(true);
+	QVERIFY(serializer.saveCascade(&root, "Test"));
+
+	const QStringList blobs = storage.keys("__blobs");
+	QCOMPARE(blobs.size(), 1);
+	QCOMPARE(storage.read("__blobrefs/" + blobs.first()).toInt(), 2);
+	QVERIFY(storage.read("Test/left").toString().startsWith("blob:"));
+	QCOMPARE(storage.read("Test/right"), storage.read("Test/left"));
+
+	right->setOrientation(Qt::Vertical);
+	QVERIFY(serializer.loadCascade(&root, "Test"));
+	QCOMPARE(right->orientation(), Qt::Horizontal);
+}
+
+void BlobTest::released()
+{
+	QWidget root;
+	root.setObjectName("root");
+	QSplitter *left = addSplitter(&root, "left");
+	QSplitter *right = addSplitter(&root, "right");
+
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setDedupBlobs(true);
+	QVERIFY(serializer.saveCascade(&root, "Test"));
+
+	right->setOrientation(Qt::Vertical);
+	QVERIFY(serializer.saveCascade(&root, "Test"));
+	QStringList blobs = storage.keys("__blobs");
+	QCOMPARE(blobs.size(), 2);
+	for (const QString &hash : blobs) {
+		QCOMPARE(storage.read("__blobrefs/" + hash).toInt(), 1);
+	}
+
+	left->setOrientation(Qt::Vertical);
+	QVERIFY(serializer.saveCascade(&root, "Test"));
+	blobs = storage.keys("__blobs");
+	QCOMPARE(blobs.size(), 1);
+	QCOMPARE(storage.read("__blobrefs/" + blobs.first()).toInt(), 2);
+	QCOMPARE(storage.keys("__blobrefs").size(), 1);
+}
+
+QTEST_MAIN(BlobTest)
+
+#include "BlobTest.moc"
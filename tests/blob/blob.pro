@@ -0,0 +1,5 @@
+TARGET = blob-test
+
+include(../tests.pri)
+
+SOURCES += BlobTest.cpp
@@ -0,0 +1,148 @@
+#include <QtTest>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QTabWidget>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/MemoryStorage>
+
+#include "Offscreen.h"
+
+class CompactionTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void cleanup();
+
+	void staleKeys();
+	void nothingCollected();
+	void deferredPages();
+	void omittedHistory();
+	void eraseAll();
+
+private:
+	QWidget *m_root = nullptr;
+	QTabWidget *m_tabs = nullptr;
+	QLineEdit *m_first = nullptr;
+	QComboBox *m_combo = nullptr;
+	QDX::MemoryStorage m_storage;
+};
+
+void CompactionTest::init()
+{
+	m_root = new QWidget();
+	m_root->setObjectName("root");
+	m_tabs = new QTabWidget(m_root);
+	m_tabs->setObjectName("tabs");
+	QWidget *first_page = new QWidget();
+	m_first = new QLineEdit(first_page);
+	m_first->setObjectName("first");
+	QWidget *second_page = new QWidget();
+	QLineEdit *second = new QLineEdit(second_page);
+	second->setObjectName("second");
+	m_tabs->addTab(first_page, "First");
+	m_tabs->addTab(second_page, "Second");
+	m_combo = new QComboBox(m_root);
+	m_combo->setObjectName("combo");
+	m_combo->setEditable(true);
+	m_combo->setProperty(QDX::WidgetSerializer::HISTORY, 10);
+
+	m_storage.clear();
+	m_storage.write("Test/tabs", 0);
+	m_storage.write("Test/first", QString("one"));
+	m_storage.write("Test/second", QString("two"));
+	m_storage.write("Test/combo", QString("current"));
+	m_storage.write("Test/combo.items", QStringList() << "current" << "older");
+	m_storage.write("Test/stale", QString("removed widget"));
+}
+
+void CompactionTest::cleanup()
+{
+	delete m_root;
+	m_root = nullptr;
+}
+
+void CompactionTest::staleKeys()
+{
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+	serializer.setCollectKeys(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	QDX::MemoryStorage archive;
+	int removed = -1;
+	serializer.compact(&archive, &removed);
+	QCOMPARE(removed, 1);
+	QVERIFY(m_storage.read("Test/stale").isValid() == false);
+	QCOMPARE(archive.read("Test/stale").toString(), QString("removed widget"));
+	QVERIFY(m_storage.read("Test/first").isValid());
+	QVERIFY(m_storage.read("Test/second").isValid());
+	QVERIFY(m_storage.read("Test/combo.items").isValid());
+}
+
+void CompactionTest::nothingCollected()
+{
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	int removed = -1;
+	QCOMPARE(serializer.compact(nullptr, &removed), qint64(0));
+	QCOMPARE(removed, 0);
+	QVERIFY(m_storage.read("Test/stale").isValid());
+
+	serializer.setCollectKeys(true);
+	QCOMPARE(serializer.compact(QSet<QString>(), nullptr, &removed), qint64(0));
+	QCOMPARE(removed, 0);
+	QVERIFY(m_storage.read("Test/stale").isValid());
+}
+
+void CompactionTest::deferredPages()
+{
+	m_root->show();
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+	serializer.setLazyLoad(true);
+	serializer.setCollectKeys(true);
+
+	QVERIFY(serializer.loadCascade(m_root, "Test"));
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	int removed = -1;
+	serializer.compact(nullptr, &removed);
+	QCOMPARE(removed, 1);
+	QCOMPARE(m_storage.read("Test/second").toString(), QString("two"));
+	QCOMPARE(m_storage.read("Test/first").toString(), QString("one"));
+}
+
+void CompactionTest::omittedHistory()
+{
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+	serializer.setOmitHistory(true);
+	serializer.setCollectKeys(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	int removed = -1;
+	serializer.compact(nullptr, &removed);
+	QCOMPARE(removed, 1);
+	QCOMPARE(m_storage.read("Test/combo.items").toStringList(), QStringList() << "current" << "older");
+}
+
+void CompactionTest::eraseAll()
+{
+	m_storage.eraseAll(QStringList() << "Test/first" << "Test/stale" << "Test/missing");
+	QCOMPARE(m_storage.values().size(), 4);
+	QVERIFY(m_storage.read("Test/first").isValid() == false);
+	QVERIFY(m_storage.read("Test/stale").isValid() == false);
+	QVERIFY(m_storage.read("Test/second").isValid());
+}
+
+QTEST_MAIN(CompactionTest)
+
+#include "CompactionTest.moc"
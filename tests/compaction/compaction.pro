@@ -0,0 +1,5 @@
+TARGET = compaction-test
+
+include(../tests.pri)
+
+SOURCES += CompactionTest.cpp
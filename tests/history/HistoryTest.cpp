@@ -0,0 +1,98 @@
+#include <QtTest>
+
+#include <QDX/WidgetSerializer>
+
+class HistoryTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void roundTrip_data();
+	void roundTrip();
+	void legacy();
+	void corrupt();
+
+private:
+	static QStringList largeHistory();
+};
+
+QStringList HistoryTest::largeHistory()
+{
+	QStringList items;
+	for (int i = 0; i < 1000; ++i) {
+		items.append(QString("search term %1").arg(i));
+	}
+	return items;
+}
+
+void HistoryTest::roundTrip_data()
+{
+	QTest::addColumn<QStringList>("items");
+	QTest::addColumn<bool>("compress");
+
+	QTest::newRow("empty") << QStringList() << false;
+	QTest::newRow("empty item") << (QStringList() << QString() << "text") << false;
+	QTest::newRow("unicode") << (QStringList() << QString::fromUtf8("\xE6\x97\xA5\xE6\x9C\xAC") << QString::fromUtf8("\xF0\x9F\x94\x8D")) << false;
+	QTest::newRow("large") << largeHistory() << false;
+	QTest::newRow("large compressed") << largeHistory() << true;
+	QTest::newRow("long item") << (QStringList() << QString(200, 'a')) << true;
+}
+
+void HistoryTest::roundTrip()
+{
+	QFETCH(QStringList, items);
+	QFETCH(bool, compress);
+
+	const QByteArray data = QDX::WidgetSerializer::encodeHistory(items, compress);
+	QVERIFY(data.startsWith("QDXH"));
+
+	QStringList decoded;
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(data, decoded));
+	QCOMPARE(decoded, items);
+}
+
+void HistoryTest::legacy()
+{
+	const QStringList items = QStringList() << "one" << "two" << "three";
+	QStringList decoded;
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(QVariant(items), decoded));
+	QCOMPARE(decoded, items);
+}
+
+void HistoryTest::corrupt()
+{
+	const QStringList items = QStringList() << "alpha" << QString() << QString::fromUtf8("\xCE\xB2");
+	const QByteArray data = QDX::WidgetSerializer::encodeHistory(items);
+	QStringList decoded;
+
+	for (int size = 0; size < data.size(); ++size) {
+		QVERIFY2(QDX::WidgetSerializer::decodeHistory(data.left(size), decoded) == false, qPrintable(QString("truncated to %1 bytes").arg(size)));
+		QVERIFY(decoded.isEmpty());
+	}
+
+	QByteArray magic = data;
+	magic[0] = 'X';
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(magic, decoded) == false);
+
+	QByteArray version = data;
+	version[4] = char(2);
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(version, decoded) == false);
+
+	QByteArray compressed = data;
+	compressed[5] = char(0x01);
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(compressed, decoded) == false);
+
+	QByteArray count = QByteArray("QDXH") + char(1) + char(0) + QByteArray("\xFF\xFF\xFF\xFF\x0F", 5);
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(count, decoded) == false);
+	QVERIFY(decoded.isEmpty());
+
+	QByteArray length = QByteArray("QDXH") + char(1) + char(0) + char(1) + QByteArray("\xFF\xFF\xFF\xFF\x0F", 5) + "abc";
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(length, decoded) == false);
+
+	QByteArray overlong = QByteArray("QDXH") + char(1) + char(0) + QByteArray("\x80\x80\x80\x80\x80\x01", 6);
+	QVERIFY(QDX::WidgetSerializer::decodeHistory(overlong, decoded) == false);
+}
+
+QTEST_GUILESS_MAIN(HistoryTest)
+
+#include "HistoryTest.moc"
@@ -0,0 +1,5 @@
+TARGET = history-test
+
+include(../tests.pri)
+
+SOURCES += HistoryTest.cpp
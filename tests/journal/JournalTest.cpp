@@ -0,0 +1,174 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <QDX/JournalStorage>
+
+class JournalTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void roundTrip();
+	void tornTail();
+	void corruptRecord();
+
+private:
+	static QDX::MemoryStorage::Values sampleValues();
+	static QByteArray readAll(const QString &file_name);
+	static bool writeAll(const QString &file_name, const QByteArray &data);
+};
+
+QDX::MemoryStorage::Values JournalTest::sampleValues()
+{
+	QDX::MemoryStorage::Values values;
+	values.insert("MainWindow/geometry", QByteArray("\x01\x02\x03\x00\xFF", 5));
+	values.insert("MainWindow/checkBox", true);
+	values.insert("MainWindow/spinBox", 42);
+	values.insert("MainWindow/doubleSpinBox", 2.5);
+	values.insert("MainWindow/lineEdit", QString::fromUtf8("\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82"));
+	values.insert("MainWindow/comboBox.items", QStringList() << "one" << "two");
+	values.insert("Dialog/lineEdit", QString());
+	return values;
+}
+
+QByteArray JournalTest::readAll(const QString &file_name)
+{
+	QFile file(file_name);
+	if (file.open(QIODevice::ReadOnly) == false) {
+		return QByteArray();
+	}
+	return file.readAll();
+}
+
+bool JournalTest::writeAll(const QString &file_name, const QByteArray &data)
+{
+	QFile file(file_name);
+	if (file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false) {
+		return false;
+	}
+	return file.write(data) == data.size();
+}
+
+void JournalTest::roundTrip()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString file_name = dir.filePath("settings.qdx");
+	const QDX::MemoryStorage::Values values = sampleValues();
+
+	{
+		QDX::JournalStorage storage(file_name);
+		storage.setCompactThreshold(-1);
+		QVERIFY(storage.load());
+		for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+			storage.write(it.key(), it.value());
+		}
+		storage.write("erased", 1);
+		storage.erase("erased");
+		storage.write("batch/first", 1);
+		storage.write("batch/second", 2);
+		storage.eraseAll(QStringList() << "batch/first" << "batch/second");
+		QVERIFY(storage.sync());
+		QVERIFY(storage.journalSize() > 0);
+	}
+
+	QDX::JournalStorage loaded(file_name);
+	QVERIFY(loaded.load());
+	QCOMPARE(loaded.values(), values);
+
+	QVERIFY(loaded.rewrite());
+	QCOMPARE(loaded.journalSize(), qint64(0));
+
+	QDX::JournalStorage compacted(file_name);
+	QVERIFY(compacted.load());
+	QCOMPARE(compacted.values(), values);
+}
+
+void JournalTest::tornTail()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString file_name = dir.filePath("settings.qdx");
+	const QString other_file_name = dir.filePath("other.qdx");
+
+	{
+		QDX::JournalStorage storage(file_name);
+		storage.setCompactThreshold(-1);
+		storage.write("first", 1);
+		storage.write("second", QString("two"));
+		QVERIFY(storage.sync());
+	}
+	{
+		QDX::JournalStorage other(other_file_name);
+		other.setCompactThreshold(-1);
+		other.write("third", QByteArray(64, 't'));
+		QVERIFY(other.sync());
+	}
+
+	const QString journal_file_name = file_name + ".journal";
+	const QByteArray valid = readAll(journal_file_name);
+	const QByteArray tail = readAll(other_file_name + ".journal");
+	QVERIFY(valid.isEmpty() == false);
+	QVERIFY(tail.size() > 8);
+
+	for (int size = 1; size < tail.size(); ++size) {
+		QVERIFY(writeAll(journal_file_name, valid + tail.left(size)));
+
+		QDX::JournalStorage storage(file_name);
+		storage.setCompactThreshold(-1);
+		QVERIFY(storage.load());
+		QCOMPARE(storage.read("first"), QVariant(1));
+		QCOMPARE(storage.read("second"), QVariant(QString("two")));
+		QVERIFY(storage.read("third").isValid() == false);
+		QCOMPARE(QFileInfo(journal_file_name).size(), qint64(valid.size()));
+	}
+
+	{
+		QDX::JournalStorage storage(file_name);
+		storage.setCompactThreshold(-1);
+		QVERIFY(storage.load());
+		storage.write("fourth", 4);
+		QVERIFY(storage.sync());
+	}
+
+	QDX::JournalStorage loaded(file_name);
+	QVERIFY(loaded.load());
+	QCOMPARE(loaded.read("first"), QVariant(1));
+	QCOMPARE(loaded.read("fourth"), QVariant(4));
+}
+
+void JournalTest::corruptRecord()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString file_name = dir.filePath("settings.qdx");
+	const QString journal_file_name = file_name + ".journal";
+
+	qint64 valid_size = 0;
+	{
+		QDX::JournalStorage storage(file_name);
+		storage.setCompactThreshold(-1);
+		storage.write("first", 1);
+		QVERIFY(storage.sync());
+		valid_size = storage.journalSize();
+		storage.write("second", 2);
+		QVERIFY(storage.sync());
+	}
+
+	QByteArray data = readAll(journal_file_name);
+	QVERIFY(data.size() > valid_size);
+	data[int(valid_size) + 8] = char(data.at(int(valid_size) + 8) ^ 0x5A);
+	QVERIFY(writeAll(journal_file_name, data));
+
+	QDX::JournalStorage storage(file_name);
+	QVERIFY(storage.load());
+	QCOMPARE(storage.read("first"), QVariant(1));
+	QVERIFY(storage.read("second").isValid() == false);
+	QCOMPARE(storage.journalSize(), valid_size);
+}
+
+QTEST_GUILESS_MAIN(JournalTest)
+
+#include "JournalTest.moc"
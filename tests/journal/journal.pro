@@ -0,0 +1,5 @@
+TARGET = journal-test
+
+include(../tests.pri)
+
+SOURCES += JournalTest.cpp
@@ -0,0 +1,105 @@
+#include <QtTest>
+#include <QTabWidget>
+#include <QLineEdit>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/MemoryStorage>
+
+#include "Offscreen.h"
+
+class LazyTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void cleanup();
+
+	void restoresOnShow();
+	void saveSkipsDeferredPages();
+	void showDuringCascade();
+
+private:
+	QWidget *m_root = nullptr;
+	QTabWidget *m_tabs = nullptr;
+	QLineEdit *m_first = nullptr;
+	QLineEdit *m_second = nullptr;
+	QLineEdit *m_trailing = nullptr;
+	QDX::MemoryStorage m_storage;
+};
+
+void LazyTest::init()
+{
+	m_root = new QWidget();
+	m_root->setObjectName("root");
+	m_tabs = new QTabWidget(m_root);
+	m_tabs->setObjectName("tabs");
+	QWidget *first_page = new QWidget();
+	m_first = new QLineEdit(first_page);
+	m_first->setObjectName("first");
+	QWidget *second_page = new QWidget();
+	m_second = new QLineEdit(second_page);
+	m_second->setObjectName("second");
+	m_tabs->addTab(first_page, "First");
+	m_tabs->addTab(second_page, "Second");
+	m_trailing = new QLineEdit(m_root);
+	m_trailing->setObjectName("trailing");
+	m_root->show();
+
+	m_storage.clear();
+	m_storage.write("Test/tabs", 0);
+	m_storage.write("Test/first", QString("one"));
+	m_storage.write("Test/second", QString("two"));
+	m_storage.write("Test/trailing", QString("three"));
+}
+
+void LazyTest::cleanup()
+{
+	delete m_root;
+	m_root = nullptr;
+}
+
+void LazyTest::restoresOnShow()
+{
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+	serializer.setLazyLoad(true);
+
+	QVERIFY(serializer.loadCascade(m_root, "Test"));
+	QCOMPARE(m_first->text(), QString("one"));
+	QCOMPARE(m_second->text(), QString());
+
+	m_tabs->setCurrentIndex(1);
+	QCOMPARE(m_second->text(), QString("two"));
+}
+
+void LazyTest::saveSkipsDeferredPages()
+{
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+	serializer.setLazyLoad(true);
+
+	QVERIFY(serializer.loadCascade(m_root, "Test"));
+	m_first->setText("edited");
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(m_storage.read("Test/first").toString(), QString("edited"));
+	QCOMPARE(m_storage.read("Test/second").toString(), QString("two"));
+}
+
+void LazyTest::showDuringCascade()
+{
+	QDX::WidgetSerializer serializer(m_storage);
+	serializer.setOmitWindow(true);
+	serializer.setLazyLoad(true);
+
+	connect(m_trailing, &QLineEdit::textChanged, m_tabs, [this]() {
+		m_tabs->setCurrentIndex(1);
+	});
+	QVERIFY(serializer.loadCascade(m_root, "Test"));
+	QCOMPARE(m_tabs->currentIndex(), 1);
+	QCOMPARE(m_second->text(), QString("two"));
+}
+
+QTEST_MAIN(LazyTest)
+
+#include "LazyTest.moc"
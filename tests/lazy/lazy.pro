@@ -0,0 +1,5 @@
+TARGET = lazy-test
+
+include(../tests.pri)
+
+SOURCES += LazyTest.cpp
@@ -0,0 +1,156 @@
+#include <QtTest>
+#include <QSpinBox>
+#include <QSplitter>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/MemoryStorage>
+
+#include "Offscreen.h"
+
+class ProfileTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void cleanup();
+
+	void overrides();
+	void switchProfile();
+	void sharedBlobs();
+	void compaction();
+
+private:
+	QWidget *m_root = nullptr;
+	QSpinBox *m_spin_box = nullptr;
+	QSplitter *m_splitter = nullptr;
+};
+
+void ProfileTest::init()
+{
+	m_root = new QWidget();
+	m_root->setObjectName("root");
+	m_spin_box = new QSpinBox(m_root);
+	m_spin_box->setObjectName("spinBox");
+	m_splitter = new QSplitter(m_root);
+	m_splitter->setObjectName("splitter");
+	new QWidget(m_splitter);
+	new QWidget(m_splitter);
+}
+
+void ProfileTest::cleanup()
+{
+	delete m_root;
+	m_root = nullptr;
+}
+
+void ProfileTest::overrides()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+
+	m_spin_box->setValue(1);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	QVERIFY(serializer.setProfile("Compact"));
+	QCOMPARE(serializer.profile(), QString("Compact"));
+	m_spin_box->setValue(5);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	QCOMPARE(storage.read("Test/spinBox").toInt(), 1);
+	QCOMPARE(storage.read("__profiles/Compact/values/Test/spinBox").toInt(), 5);
+	QVERIFY(storage.read("__profiles/Compact/values/Test/splitter").isValid() == false);
+	QVERIFY(serializer.profiles().contains("Compact"));
+
+	m_spin_box->setValue(1);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QVERIFY(storage.read("__profiles/Compact/values/Test/spinBox").isValid() == false);
+}
+
+void ProfileTest::switchProfile()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+
+	m_spin_box->setValue(1);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QVERIFY(serializer.setProfile("Compact"));
+	m_spin_box->setValue(5);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	QVERIFY(serializer.switchProfile(m_root, QString(), "Test"));
+	QCOMPARE(serializer.profile(), QString());
+	QCOMPARE(m_spin_box->value(), 1);
+
+	QVERIFY(serializer.switchProfile(m_root, "Compact", "Test"));
+	QCOMPARE(m_spin_box->value(), 5);
+}
+
+void ProfileTest::sharedBlobs()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setDedupBlobs(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	const QString horizontal = storage.read("Test/splitter").toString();
+	QVERIFY(horizontal.startsWith("blob:"));
+
+	QVERIFY(serializer.setProfile("Compact"));
+	m_splitter->setOrientation(Qt::Vertical);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	const QString vertical = storage.read("__profiles/Compact/values/Test/splitter").toString();
+	QVERIFY(vertical.startsWith("blob:"));
+	QVERIFY(vertical != horizontal);
+
+	QVERIFY(storage.keys("__profiles/Compact/values/__blobs").isEmpty());
+	QVERIFY(storage.keys("__profiles/Compact/values/__blobrefs").isEmpty());
+	QCOMPARE(storage.keys("__blobs").size(), 2);
+	QCOMPARE(storage.read("__blobrefs/" + horizontal.mid(5)).toInt(), 1);
+	QCOMPARE(storage.read("__blobrefs/" + vertical.mid(5)).toInt(), 1);
+
+	QVERIFY(serializer.switchProfile(m_root, QString(), "Test"));
+	QCOMPARE(m_splitter->orientation(), Qt::Horizontal);
+
+	QVERIFY(serializer.setProfile("Compact"));
+	m_splitter->setOrientation(Qt::Horizontal);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QVERIFY(storage.read("__profiles/Compact/values/Test/splitter").isValid() == false);
+	QCOMPARE(storage.keys("__blobs").size(), 1);
+	QCOMPARE(storage.read("__blobrefs/" + horizontal.mid(5)).toInt(), 1);
+}
+
+void ProfileTest::compaction()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setDedupBlobs(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QVERIFY(serializer.setProfile("Compact"));
+	m_splitter->setOrientation(Qt::Vertical);
+	serializer.setCollectKeys(true);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	storage.write("__blobrefs/" + storage.keys("__blobs").first(), 7);
+	int removed = -1;
+	serializer.compact(nullptr, &removed);
+	QCOMPARE(removed, 0);
+
+	const QStringList blobs = storage.keys("__blobs");
+	QCOMPARE(blobs.size(), 2);
+	for (const QString &hash : blobs) {
+		QCOMPARE(storage.read("__blobrefs/" + hash).toInt(), 1);
+	}
+
+	QVERIFY(serializer.switchProfile(m_root, QString(), "Test"));
+	QCOMPARE(m_splitter->orientation(), Qt::Horizontal);
+}
+
+QTEST_MAIN(ProfileTest)
+
+#include "ProfileTest.moc"
@@ -0,0 +1,5 @@
+TARGET = profile-test
+
+include(../tests.pri)
+
+SOURCES += ProfileTest.cpp
@@ -0,0 +1,106 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDataStream>
+
+#include <QDX/SnapshotStorage>
+
+class SnapshotTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void roundTrip();
+	void corrupt();
+
+private:
+	static QDX::MemoryStorage::Values sampleValues();
+	static bool writeAll(const QString &file_name, const QByteArray &data);
+};
+
+QDX::MemoryStorage::Values SnapshotTest::sampleValues()
+{
+	QDX::MemoryStorage::Values values;
+	values.insert("MainWindow/geometry", QByteArray("\x01\x02\x03\x00\xFF", 5));
+	values.insert("MainWindow/splitter", QByteArray(300, 'x'));
+	values.insert("MainWindow/checkBox", true);
+	values.insert("MainWindow/spinBox", 42);
+	values.insert("MainWindow/doubleSpinBox", 2.5);
+	values.insert("MainWindow/lineEdit", QString::fromUtf8("\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82"));
+	values.insert("MainWindow/comboBox.items", QStringList() << "one" << "two");
+	values.insert("Dialog/lineEdit", QString());
+	values.insert("root", QString("value"));
+	return values;
+}
+
+bool SnapshotTest::writeAll(const QString &file_name, const QByteArray &data)
+{
+	QFile file(file_name);
+	if (file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false) {
+		return false;
+	}
+	return file.write(data) == data.size();
+}
+
+void SnapshotTest::roundTrip()
+{
+	const QDX::MemoryStorage::Values values = sampleValues();
+
+	QDX::MemoryStorage::Values decoded;
+	QVERIFY(QDX::SnapshotStorage::decode(QDX::SnapshotStorage::encode(values), decoded));
+	QCOMPARE(decoded, values);
+
+	QDX::MemoryStorage::Values empty;
+	QVERIFY(QDX::SnapshotStorage::decode(QDX::SnapshotStorage::encode(QDX::MemoryStorage::Values()), empty));
+	QVERIFY(empty.isEmpty());
+
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString file_name = dir.filePath("settings.qdx");
+	QDX::SnapshotStorage storage(file_name);
+	storage.setValues(values);
+	QVERIFY(storage.save());
+
+	QDX::SnapshotStorage loaded(file_name);
+	QVERIFY(loaded.load());
+	QCOMPARE(loaded.values(), values);
+}
+
+void SnapshotTest::corrupt()
+{
+	const QByteArray data = QDX::SnapshotStorage::encode(sampleValues());
+	QDX::MemoryStorage::Values decoded;
+
+	for (int size = 0; size < data.size(); ++size) {
+		QVERIFY2(QDX::SnapshotStorage::decode(data.left(size), decoded) == false, qPrintable(QString("truncated to %1 bytes").arg(size)));
+	}
+
+	QByteArray magic = data;
+	magic[0] = char(magic.at(0) ^ 0xFF);
+	QVERIFY(QDX::SnapshotStorage::decode(magic, decoded) == false);
+
+	QByteArray version = data;
+	version[7] = char(2);
+	QVERIFY(QDX::SnapshotStorage::decode(version, decoded) == false);
+
+	QByteArray segment;
+	QDataStream stream(&segment, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_6);
+	stream << quint32(0x51445853) << quint32(1);
+	stream << quint32(1) << QByteArray("key");
+	stream << quint32(1) << quint16(1) << quint32(7) << QVariant(1);
+	QVERIFY(QDX::SnapshotStorage::decode(segment, decoded) == false);
+
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString file_name = dir.filePath("settings.qdx");
+	QVERIFY(writeAll(file_name, data.left(data.size() - 1)));
+	QDX::SnapshotStorage storage(file_name);
+	storage.write("kept", 1);
+	QVERIFY(storage.load() == false);
+	QCOMPARE(storage.read("kept"), QVariant(1));
+}
+
+QTEST_GUILESS_MAIN(SnapshotTest)
+
+#include "SnapshotTest.moc"
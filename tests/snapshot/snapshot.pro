@@ -0,0 +1,5 @@
+TARGET = snapshot-test
+
+include(../tests.pri)
+
+SOURCES += SnapshotTest.cpp
@@ -0,0 +1,10 @@
+QT += core gui widgets testlib
+
+CONFIG += console c++11 testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD
+
+include($$PWD/../src/WidgetSerializer.pri)
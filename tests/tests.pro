@@ -0,0 +1,11 @@
+TEMPLATE = subdirs
+
+SUBDIRS += history \
+  snapshot \
+  journal \
+  blob \
+  tracking \
+  lazy \
+  transaction \
+  profile \
+  compaction
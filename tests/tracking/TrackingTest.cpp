@@ -0,0 +1,112 @@
+#include <QtTest>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLineEdit>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/MemoryStorage>
+
+#include "Offscreen.h"
+
+class TrackingTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void cleanup();
+
+	void skipsUnchanged();
+	void tracksLoadedValues();
+	void clearTrackedValues();
+
+private:
+	QWidget *m_root = nullptr;
+	QSpinBox *m_spin_box = nullptr;
+	QLineEdit *m_line_edit = nullptr;
+};
+
+void TrackingTest::init()
+{
+	m_root = new QWidget();
+	m_root->setObjectName("root");
+	QCheckBox *check_box = new QCheckBox(m_root);
+	check_box->setObjectName("checkBox");
+	m_spin_box = new QSpinBox(m_root);
+	m_spin_box->setObjectName("spinBox");
+	m_line_edit = new QLineEdit(m_root);
+	m_line_edit->setObjectName("lineEdit");
+}
+
+void TrackingTest::cleanup()
+{
+	delete m_root;
+	m_root = nullptr;
+}
+
+void TrackingTest::skipsUnchanged()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setTrackChanges(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 3);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 0);
+
+	m_spin_box->setValue(5);
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 1);
+	QCOMPARE(storage.read("Test/spinBox").toInt(), 5);
+}
+
+void TrackingTest::tracksLoadedValues()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setTrackChanges(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	storage.write("Test/spinBox", 7);
+	storage.write("Test/lineEdit", QString("restored"));
+
+	QVERIFY(serializer.loadCascade(m_root, "Test"));
+	QCOMPARE(m_spin_box->value(), 7);
+	QCOMPARE(m_line_edit->text(), QString("restored"));
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 0);
+
+	m_line_edit->setText("edited");
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 1);
+	QCOMPARE(storage.read("Test/lineEdit").toString(), QString("edited"));
+}
+
+void TrackingTest::clearTrackedValues()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setTrackChanges(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	storage.clear();
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 0);
+	QVERIFY(storage.values().isEmpty());
+
+	serializer.clearTrackedValues();
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(serializer.writeCount(), 3);
+	QCOMPARE(storage.values().size(), 3);
+}
+
+QTEST_MAIN(TrackingTest)
+
+#include "TrackingTest.moc"
@@ -0,0 +1,5 @@
+TARGET = tracking-test
+
+include(../tests.pri)
+
+SOURCES += TrackingTest.cpp
@@ -0,0 +1,109 @@
+#include <QtTest>
+#include <QCheckBox>
+#include <QSpinBox>
+
+#include <QDX/WidgetSerializer>
+#include <QDX/MemoryStorage>
+
+#include "Offscreen.h"
+
+class SyncCounter : public QDX::MemoryStorage
+{
+public:
+	int syncs = 0;
+
+	bool sync() override
+	{
+		++syncs;
+		return true;
+	}
+};
+
+class TransactionTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void cleanup();
+
+	void commit();
+	void rollback();
+	void nested();
+
+private:
+	QWidget *m_root = nullptr;
+	QSpinBox *m_spin_box = nullptr;
+};
+
+void TransactionTest::init()
+{
+	m_root = new QWidget();
+	m_root->setObjectName("root");
+	QCheckBox *check_box = new QCheckBox(m_root);
+	check_box->setObjectName("checkBox");
+	m_spin_box = new QSpinBox(m_root);
+	m_spin_box->setObjectName("spinBox");
+}
+
+void TransactionTest::cleanup()
+{
+	delete m_root;
+	m_root = nullptr;
+}
+
+void TransactionTest::commit()
+{
+	SyncCounter storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+
+	QVERIFY(serializer.beginTransaction());
+	QVERIFY(serializer.inTransaction());
+	QVERIFY(serializer.saveCascade(m_root, "First"));
+	QVERIFY(serializer.saveCascade(m_root, "Second"));
+	QVERIFY(storage.values().isEmpty());
+	QVERIFY(serializer.storage().read("First/spinBox").isValid());
+
+	QVERIFY(serializer.commit());
+	QVERIFY(serializer.inTransaction() == false);
+	QCOMPARE(storage.syncs, 1);
+	QCOMPARE(storage.values().size(), 4);
+	QVERIFY(storage.read("Second/checkBox").isValid());
+}
+
+void TransactionTest::rollback()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+	serializer.setOmitWindow(true);
+	serializer.setTrackChanges(true);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+
+	m_spin_box->setValue(3);
+	QVERIFY(serializer.beginTransaction());
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	serializer.rollback();
+	QVERIFY(serializer.inTransaction() == false);
+	QCOMPARE(storage.read("Test/spinBox").toInt(), 0);
+
+	QVERIFY(serializer.saveCascade(m_root, "Test"));
+	QCOMPARE(storage.read("Test/spinBox").toInt(), 3);
+}
+
+void TransactionTest::nested()
+{
+	QDX::MemoryStorage storage;
+	QDX::WidgetSerializer serializer(storage);
+
+	QVERIFY(serializer.commit() == false);
+	QVERIFY(serializer.beginTransaction());
+	QVERIFY(serializer.beginTransaction() == false);
+	QVERIFY(serializer.commit());
+	QVERIFY(serializer.commit() == false);
+}
+
+QTEST_MAIN(TransactionTest)
+
+#include "TransactionTest.moc"
@@ -0,0 +1,5 @@
+TARGET = transaction-test
+
+include(../tests.pri)
+
+SOURCES += TransactionTest.cpp